@@ -0,0 +1,36 @@
+#include "adc_block.h"
+
+void adcWindowReset(AdcWindow &window)
+{
+    window.sum = 0;
+    window.count = 0;
+}
+
+void adcWindowAdd(AdcWindow &window, const uint8_t *data, uint32_t length, uint8_t channel)
+{
+    for (uint32_t i = 0; i + ADC_RESULT_BYTES <= length; i += ADC_RESULT_BYTES)
+    {
+        uint16_t result = (uint16_t)(data[i] | (data[i + 1] << 8));
+        if ((result >> 12) == channel)
+        {
+            window.sum += result & 0x0FFF;
+            window.count++;
+        }
+    }
+}
+
+bool adcWindowAverage(const AdcWindow &window, uint32_t &averageRaw)
+{
+    if (window.count == 0)
+    {
+        return false;
+    }
+
+    averageRaw = (window.sum + window.count / 2) / window.count;
+    return true;
+}
+
+float adcPinToPackVoltage(float pinMv)
+{
+    return pinMv / 1000.0f * ADC_DIVIDER_RATIO;
+}
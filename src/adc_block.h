@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+// ===== ADC Block Processing =====
+// Hardware-independent half of the ADC sampler: summing the raw codes of DMA
+// blocks into an averaging window and mapping the pin voltage to pack voltage.
+
+#define ADC_RESULT_BYTES 2            // TYPE1 result: data in bits 0-11, channel in bits 12-15
+#define ADC_RAW_MAX 4095
+#define ADC_DIVIDER_RATIO 5.545f      // (100k + 22k) / 22k divider to the pin
+
+// Raw codes of one channel summed across any number of DMA blocks
+struct AdcWindow
+{
+    uint32_t sum;
+    uint32_t count;
+};
+
+void adcWindowReset(AdcWindow &window);
+void adcWindowAdd(AdcWindow &window, const uint8_t *data, uint32_t length, uint8_t channel);
+bool adcWindowAverage(const AdcWindow &window, uint32_t &averageRaw); // Rounded mean; false if empty
+
+// Plain divider: pin mV -> pack V. No pack-level curve is applied, so the
+// eFuse calibration's error at 11 dB above about 2.5 V at the pin (packs above
+// ~13.9 V) passes through.
+float adcPinToPackVoltage(float pinMv);
@@ -0,0 +1,156 @@
+#include "adc_sampler.h"
+
+#include <Arduino.h>
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+#include <soc/soc_caps.h>
+
+#include "text_log.h"
+
+#define ADC_READ_BYTES (ADC_BLOCK_SAMPLES * ADC_RESULT_BYTES)
+// Bytes held by the driver between polls: one loop budget of samples, in whole blocks
+#define ADC_DMA_BUFFER ((ADC_SAMPLE_FREQ_HZ / 1000 * ADC_LOOP_BUDGET_MS * ADC_RESULT_BYTES / ADC_READ_BYTES + 1) * ADC_READ_BYTES)
+#define ADC_MAX_READS_PER_POLL (ADC_DMA_BUFFER / ADC_READ_BYTES + 1) // Drain a full buffer, then stop
+#define ADC_DEFAULT_VREF 1100        // mV, used when the eFuse holds no calibration
+#define ADC_WINDOW_SAMPLES (ADC_SAMPLE_FREQ_HZ / 1000 * ADC_WINDOW_MS)
+
+static_assert(ADC_RESULT_BYTES == SOC_ADC_DIGI_RESULT_BYTES, "ADC result layout");
+static_assert(ADC_SAMPLE_FREQ_HZ >= SOC_ADC_SAMPLE_FREQ_THRES_LOW &&
+              ADC_SAMPLE_FREQ_HZ <= SOC_ADC_SAMPLE_FREQ_THRES_HIGH, "ADC rate outside the continuous-mode range");
+static_assert(ADC_WINDOW_SAMPLES % ADC_BLOCK_SAMPLES == 0, "ADC window must end on a DMA block boundary");
+
+static esp_adc_cal_characteristics_t adcCharacteristics;
+static uint8_t readBuffer[ADC_READ_BYTES];
+static AdcWindow window;
+static bool samplerRunning = false;
+static bool voltageValid = false;
+static float latestPackVoltage = 0;
+static uint32_t blocks = 0;
+static uint32_t overruns = 0;
+
+static void logFailure(const char *step, esp_err_t err)
+{
+    textLog.print("ADC: ");
+    textLog.print(step);
+    textLog.print(" failed: ");
+    textLog.println(esp_err_to_name(err));
+}
+
+bool adcSamplerBegin()
+{
+    adc_digi_init_config_t initConfig = {};
+    initConfig.max_store_buf_size = ADC_DMA_BUFFER;
+    initConfig.conv_num_each_intr = ADC_READ_BYTES;
+    initConfig.adc1_chan_mask = BIT(ADC1_CHANNEL_0);
+    initConfig.adc2_chan_mask = 0;
+    esp_err_t err = adc_digi_initialize(&initConfig);
+    if (err != ESP_OK)
+    {
+        logFailure("continuous mode init", err);
+        return false;
+    }
+
+    adc_digi_pattern_config_t pattern = {};
+    pattern.atten = ADC_ATTEN_DB_11;
+    pattern.channel = ADC1_CHANNEL_0;
+    pattern.unit = 0; // ADC1
+    pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+    adc_digi_configuration_t digiConfig = {};
+    digiConfig.conv_limit_en = 1;
+    digiConfig.conv_limit_num = 250;
+    digiConfig.pattern_num = 1;
+    digiConfig.adc_pattern = &pattern;
+    digiConfig.sample_freq_hz = ADC_SAMPLE_FREQ_HZ;
+    digiConfig.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    digiConfig.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+    err = adc_digi_controller_configure(&digiConfig);
+    if (err == ESP_OK)
+    {
+        err = adc_digi_start();
+    }
+    if (err != ESP_OK)
+    {
+        logFailure("continuous mode start", err);
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, ADC_DEFAULT_VREF, &adcCharacteristics);
+
+    adcWindowReset(window);
+    samplerRunning = true;
+    textLog.print("ADC: sampling GPIO ");
+    textLog.print(ADC_PACK_PIN);
+    textLog.print(" at ");
+    textLog.print(ADC_SAMPLE_FREQ_HZ);
+    textLog.print(" Hz, buffer ");
+    textLog.print(ADC_DMA_BUFFER);
+    textLog.println(" bytes");
+    return true;
+}
+
+static void processBlock(const uint8_t *data, uint32_t length)
+{
+    adcWindowAdd(window, data, length, ADC1_CHANNEL_0);
+    blocks++;
+    if (window.count < ADC_WINDOW_SAMPLES)
+    {
+        return;
+    }
+
+    // Average the raw codes of the whole window, then calibrate once
+    uint32_t averageRaw;
+    adcWindowAverage(window, averageRaw);
+    adcWindowReset(window);
+
+    uint32_t pinMv = esp_adc_cal_raw_to_voltage(averageRaw, &adcCharacteristics);
+    latestPackVoltage = adcPinToPackVoltage((float)pinMv);
+    voltageValid = true;
+}
+
+void adcSamplerPoll()
+{
+    if (!samplerRunning)
+    {
+        return;
+    }
+
+    for (uint8_t reads = 0; reads < ADC_MAX_READS_PER_POLL; reads++)
+    {
+        uint32_t length = 0;
+        esp_err_t result = adc_digi_read_bytes(readBuffer, ADC_READ_BYTES, &length, 0);
+        if (result == ESP_ERR_INVALID_STATE)
+        {
+            // Driver buffer overflowed since the last poll; the data read is still
+            // usable, but the window no longer covers whole mains periods
+            overruns++;
+            adcWindowReset(window);
+        }
+        else if (result != ESP_OK)
+        {
+            return; // Nothing pending
+        }
+        processBlock(readBuffer, length);
+    }
+}
+
+bool adcPackVoltageValid()
+{
+    return voltageValid;
+}
+
+float adcPackVoltage()
+{
+    return latestPackVoltage;
+}
+
+uint32_t adcBlockCount()
+{
+    return blocks;
+}
+
+uint32_t adcOverruns()
+{
+    return overruns;
+}
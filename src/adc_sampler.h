@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "adc_block.h"
+
+// ===== ADC Pack Voltage Sampler =====
+// Second voltage source next to the INA219: ADC1 in continuous (DMA) mode on
+// GPIO 36 behind a resistor divider. Every sample is summed into a window of
+// whole mains periods, and only the window average goes through the eFuse
+// calibration and the divider (adc_block.h).
+
+#define ADC_PACK_PIN 36              // ADC1 channel 0
+#define ADC_SAMPLE_FREQ_HZ 20000     // Lowest continuous-mode rate on the ESP32
+#define ADC_BLOCK_SAMPLES 100        // Samples per DMA read
+#define ADC_WINDOW_MS 100            // Averaging window: 5 periods of 50 Hz, 6 of 60 Hz
+#define ADC_LOOP_BUDGET_MS 200       // Worst-case gap between polls: delay(50), OLED update, I2C reads
+#define ADC_CROSSCHECK_TOLERANCE 0.5f // Volts between ADC and INA219 before flagging
+
+bool adcSamplerBegin();
+void adcSamplerPoll();               // Drains the DMA buffer, never blocks
+
+bool adcPackVoltageValid();
+float adcPackVoltage();              // Latest window average (V)
+uint32_t adcBlockCount();
+uint32_t adcOverruns();              // DMA buffer overflows (samples lost)
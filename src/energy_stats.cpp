@@ -0,0 +1,200 @@
+#include "energy_stats.h"
+
+#include <string.h>
+
+#define MINUTES_PER_HOUR 60
+#define MINUTES_PER_DAY 1440
+
+struct RollupRing
+{
+    EnergyRollup *slots;
+    uint8_t capacity;
+    uint8_t head;   // Next slot to write
+    uint8_t count;
+};
+
+static EnergyRollup minuteSlots[ENERGY_MINUTE_SLOTS];
+static EnergyRollup hourSlots[ENERGY_HOUR_SLOTS];
+static EnergyRollup daySlots[ENERGY_DAY_SLOTS];
+
+static RollupRing rings[ENERGY_LEVEL_COUNT] = {
+    {minuteSlots, ENERGY_MINUTE_SLOTS, 0, 0},
+    {hourSlots, ENERGY_HOUR_SLOTS, 0, 0},
+    {daySlots, ENERGY_DAY_SLOTS, 0, 0}};
+
+// Open period per level; each one holds only what has been closed below it
+static EnergyRollup current[ENERGY_LEVEL_COUNT];
+
+static uint64_t lastSampleMs = 0;
+static float lastPowerW = 0;
+static float lastCurrentA = 0;
+static bool haveLastSample = false;
+
+static const uint32_t levelMinutes[ENERGY_LEVEL_COUNT] = {1, MINUTES_PER_HOUR, MINUTES_PER_DAY};
+
+static void resetRollup(EnergyRollup &rollup, uint32_t startMinute)
+{
+    memset(&rollup, 0, sizeof(rollup));
+    rollup.startMinute = startMinute;
+}
+
+// Combine two partial results (Chan et al. parallel variance)
+static void mergeRollup(EnergyRollup &into, const EnergyRollup &from)
+{
+    into.wh += from.wh;
+    into.ah += from.ah;
+    into.chargeMs += from.chargeMs;
+    into.dischargeMs += from.dischargeMs;
+
+    if (from.count == 0)
+    {
+        return;
+    }
+    if (into.count == 0)
+    {
+        into.count = from.count;
+        into.minW = from.minW;
+        into.maxW = from.maxW;
+        into.meanW = from.meanW;
+        into.m2 = from.m2;
+        return;
+    }
+
+    float n = (float)into.count + (float)from.count;
+    float delta = from.meanW - into.meanW;
+    into.meanW += delta * (float)from.count / n;
+    into.m2 += from.m2 + delta * delta * (float)into.count * (float)from.count / n;
+    into.count += from.count;
+    if (from.minW < into.minW) into.minW = from.minW;
+    if (from.maxW > into.maxW) into.maxW = from.maxW;
+}
+
+static void pushRollup(EnergyLevel level, const EnergyRollup &rollup)
+{
+    RollupRing &ring = rings[level];
+    ring.slots[ring.head] = rollup;
+    ring.head = (ring.head + 1) % ring.capacity;
+    if (ring.count < ring.capacity)
+    {
+        ring.count++;
+    }
+}
+
+// Close every level whose period does not contain minuteIndex
+static void rollPeriods(uint32_t minuteIndex)
+{
+    for (uint8_t level = 0; level < ENERGY_LEVEL_COUNT; level++)
+    {
+        uint32_t start = minuteIndex - minuteIndex % levelMinutes[level];
+        if (current[level].startMinute == start)
+        {
+            // Higher levels start on boundaries of this one, so they are still open too
+            return;
+        }
+
+        if (current[level].count > 0)
+        {
+            pushRollup((EnergyLevel)level, current[level]);
+            if (level + 1 < ENERGY_LEVEL_COUNT)
+            {
+                mergeRollup(current[level + 1], current[level]);
+            }
+        }
+        resetRollup(current[level], start);
+    }
+}
+
+void energyStatsBegin(uint64_t nowMs)
+{
+    uint32_t minuteIndex = (uint32_t)(nowMs / 60000);
+    for (uint8_t level = 0; level < ENERGY_LEVEL_COUNT; level++)
+    {
+        resetRollup(current[level], minuteIndex - minuteIndex % levelMinutes[level]);
+        rings[level].head = 0;
+        rings[level].count = 0;
+    }
+    haveLastSample = false;
+}
+
+void energyStatsAddSample(uint64_t nowMs, float powerW, float currentA, bool charging)
+{
+    rollPeriods((uint32_t)(nowMs / 60000));
+
+    EnergyRollup &minute = current[ENERGY_MINUTE];
+
+    // Welford update of the power distribution
+    minute.count++;
+    if (minute.count == 1)
+    {
+        minute.minW = powerW;
+        minute.maxW = powerW;
+    }
+    else
+    {
+        if (powerW < minute.minW) minute.minW = powerW;
+        if (powerW > minute.maxW) minute.maxW = powerW;
+    }
+    float delta = powerW - minute.meanW;
+    minute.meanW += delta / (float)minute.count;
+    minute.m2 += delta * (powerW - minute.meanW);
+
+    // Trapezoidal integration since the previous sample
+    if (haveLastSample && nowMs > lastSampleMs && nowMs - lastSampleMs <= ENERGY_MAX_GAP_MS)
+    {
+        uint32_t dtMs = (uint32_t)(nowMs - lastSampleMs);
+        float hours = (float)dtMs / 3600000.0f;
+        minute.wh += (powerW + lastPowerW) * 0.5f * hours;
+        minute.ah += (currentA + lastCurrentA) * 0.5f * hours;
+        if (charging)
+        {
+            minute.chargeMs += dtMs;
+        }
+        else
+        {
+            minute.dischargeMs += dtMs;
+        }
+    }
+
+    lastSampleMs = nowMs;
+    lastPowerW = powerW;
+    lastCurrentA = currentA;
+    haveLastSample = true;
+}
+
+bool energyStatsCurrent(EnergyLevel level, EnergyRollup &out)
+{
+    if (level >= ENERGY_LEVEL_COUNT)
+    {
+        return false;
+    }
+
+    out = current[level];
+    for (int8_t lower = (int8_t)level - 1; lower >= 0; lower--)
+    {
+        mergeRollup(out, current[lower]);
+    }
+    return out.count > 0;
+}
+
+uint8_t energyStatsCount(EnergyLevel level)
+{
+    return level < ENERGY_LEVEL_COUNT ? rings[level].count : 0;
+}
+
+bool energyStatsGet(EnergyLevel level, uint8_t index, EnergyRollup &out)
+{
+    if (level >= ENERGY_LEVEL_COUNT || index >= rings[level].count)
+    {
+        return false;
+    }
+
+    const RollupRing &ring = rings[level];
+    uint8_t slot = (ring.head + ring.capacity - 1 - index) % ring.capacity;
+    out = ring.slots[slot];
+    return true;
+}
+
+float energyRollupVariance(const EnergyRollup &rollup)
+{
+    return rollup.count > 1 ? rollup.m2 / (float)rollup.count : 0.0f;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+
+// ===== Energy Analytics =====
+// Streaming per-minute/hour/day rollups of the power samples. Each sample is
+// folded in with O(1) work; closed periods are kept in fixed-size rings.
+
+#define ENERGY_MINUTE_SLOTS 60  // Last hour of minutes
+#define ENERGY_HOUR_SLOTS 48    // Last two days of hours
+#define ENERGY_DAY_SLOTS 31     // Last month of days
+#define ENERGY_MAX_GAP_MS 5000  // Sample gaps longer than this are not integrated
+
+enum EnergyLevel : uint8_t
+{
+    ENERGY_MINUTE = 0,
+    ENERGY_HOUR,
+    ENERGY_DAY,
+    ENERGY_LEVEL_COUNT
+};
+
+struct EnergyRollup
+{
+    uint32_t startMinute;   // Monotonic minute index where the period starts
+    uint32_t count;         // Number of samples
+    float minW;
+    float maxW;             // Peak load
+    float meanW;
+    float m2;               // Sum of squared deviations (Welford)
+    float wh;               // Integrated energy (Wh)
+    float ah;               // Integrated charge (Ah), positive = discharge
+    uint32_t chargeMs;      // Time spent charging
+    uint32_t dischargeMs;   // Time spent discharging
+};
+
+void energyStatsBegin(uint64_t nowMs);
+void energyStatsAddSample(uint64_t nowMs, float powerW, float currentA, bool charging);
+
+// In-progress period for a level, including the not yet closed lower levels
+bool energyStatsCurrent(EnergyLevel level, EnergyRollup &out);
+
+// Closed periods: index 0 is the most recent one
+uint8_t energyStatsCount(EnergyLevel level);
+bool energyStatsGet(EnergyLevel level, uint8_t index, EnergyRollup &out);
+
+float energyRollupVariance(const EnergyRollup &rollup);
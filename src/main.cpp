@@ -2,9 +2,17 @@
 //#include <Firebase_ESP_Client.h>
 #include <Keypad.h>
 #include <GyverOLED.h>
-//#include <Adafruit_INA219.h>
+#include <Adafruit_INA219.h>
 #include <EEPROM.h>
 #include <time.h>
+#include "time_service.h"
+#include "energy_stats.h"
+#include "sprites.h"
+#include "telemetry_protocol.h"
+#include "memory_guard.h"
+#include "ui_state.h"
+#include "adc_sampler.h"
+#include "text_log.h"
 
 // ===== Battery Configuration (3S40P - 11.1V, 88Ah) =====
 #define BATTERY_MIN_VOLTAGE 9.0     // Minimum battery voltage (3.0V * 3 cells)
@@ -17,33 +25,58 @@
 #define SHUNT_VOLTAGE_CHARGING -0.01 // Shunt voltage threshold for charging
 #define SHUNT_VOLTAGE_DISCHARGING 0.01 // Shunt voltage threshold for discharging
 
+// ===== Serial Telemetry =====
+// TELEMETRY_BINARY is set in text_log.h; decode with tools/telemetry_decode.cpp
+#ifndef SERIAL_BAUD
+#define SERIAL_BAUD 115200
+#endif
+// With -D TELEMETRY_COMPRESS=1 samples are batched into telemetry_codec blocks
+#ifndef TELEMETRY_COMPRESS
+#define TELEMETRY_COMPRESS 0
+#endif
+#define TELEMETRY_BLOCK_FLUSH_MS 2000  // Longest a sample waits in an open block
+#define TELEMETRY_TX_BUFFER 1024       // UART TX buffer; the hardware FIFO alone is too small for a block
+
 // ===== Function Prototypes =====
+void drawBorder();
 void showWelcomeScreen();
-void showPinEntryScreen(bool showAttempts = false);
+void showPinEntryScreen(const UiViewModel &view);
 void showAccessGranted();
-void showAccessDenied();
+void showAccessDenied(const UiViewModel &view);
+void showLockoutScreen(const UiViewModel &view);
+void showHomeScreen(const UiViewModel &view);
+void updateUi();
+void dispatchUi(UiEvent event);
+void buildViewModel(UiViewModel &view);
+void renderUi();
 void loadSecurityState();
 void saveSecurityState();
 void checkLockoutStatus();
-void handleLockoutScreen();
+void checkLockoutExpiry();
 void handlePinEntry();
 void resetPinEntry();
 void verifyPin();
 void deleteLastDigit();
-void handleHomeScreen();
 void updatePowerData();
-void drawBatteryIcon();
-void drawChargingAnimation();
+void drawBatteryIcon(const UiViewModel &view);
+void advanceChargingAnimation();
 float calculateBatteryPercentage(float voltage);
 float mapFloat(float x, float in_min, float in_max, float out_min, float out_max);
 bool isValidKeyPress(char key);
-void initializeRTC();
-unsigned long getRealTimeSeconds();
-void saveRealTimestamp();
-unsigned long loadRealTimestamp();
+void startLockout();
+void clearLockout();
+void sendTelemetryFrame(uint8_t type, const uint8_t *payload, uint16_t length);
+void sendTelemetrySample();
+void addTelemetryBlockSample(const TelemetrySample &sample);
+void flushTelemetryBlock();
+void sendTelemetryEvent(uint8_t code, int32_t value);
+void checkMemory();
+void crossCheckVoltage(float inaVoltage);
+void checkAdcOverruns();
+void checkTelemetryDrops();
 
 // ===== Hardware Configuration =====
-//Adafruit_INA219 ina219;
+Adafruit_INA219 ina219;
 #define relay 12
 GyverOLED<SSH1106_128x64> oled;
 
@@ -64,26 +97,45 @@ Keypad customKeypad = Keypad(makeKeymap(keys), rowPins, colPins, ROWS, COLS);
 #define LOCKOUT_DURATION 120000 // 2 minutes in milliseconds (for testing)
 char enteredPin[5] = "----";    // 4 digits + null terminator
 uint8_t pinPosition = 0;
+unsigned long pinCompleteTime = 0; // When the 4th digit was entered, 0 if not complete
+bool showAttemptsHint = false;     // Attempts left are shown once the user acts on the PIN screen
+#define PIN_SUBMIT_DELAY 500       // Show the complete PIN briefly before verifying
 uint8_t failedAttempts = 0;
-unsigned long lockoutStartTime = 0;  // When lockout started
+uint64_t lockoutEndTime = 0;     // Monotonic time (ms) when lockout expires
+int64_t lockoutWallStart = 0;    // Wall time (s) when lockout started, 0 if unknown
 bool authenticated = false;
 bool systemLocked = false;
 
-// EEPROM addresses
+// EEPROM layout - the whole security record is stored as one block
 #define EEPROM_SIZE 32
-#define ATTEMPTS_ADDR 0
-#define LOCKOUT_START_ADDR 4
-#define LOCKOUT_ACTIVE_ADDR 8
-#define LOCKOUT_TIMESTAMP_ADDR 12  // Real timestamp when lockout started
-#define BOOT_TIMESTAMP_ADDR 20     // Timestamp when system last booted
+#define SECURITY_RECORD_ADDR 0
+#define SECURITY_RECORD_VERSION 0xA2 // Distinct from any attempt count in the old layout
+
+struct SecurityRecord
+{
+    uint8_t version;
+    uint8_t failedAttempts;
+    uint8_t lockoutActive;
+    uint8_t reserved;
+    uint64_t lockoutEndTime;
+    int64_t lockoutWallStart;
+};
+
+// RAM copy of what is currently in EEPROM; flash is only written when this changes
+SecurityRecord securityCache;
 
 // Power monitoring
+bool ina219Present = false;      // false = pack voltage comes from the ADC only
+bool adcPresent = false;
+bool voltageMismatch = false;    // INA219 and ADC disagree by more than the tolerance
+uint32_t reportedAdcOverruns = 0;
 float loadVoltage = 0;
 float current_A = 0;
 float power_W = 0;
 bool isCharging = false;
 bool wasCharging = false;  // Previous charging state for animation
 float batteryPercentage = 0;
+uint8_t batteryFillLevel = 0;   // Battery icon fill width (0-30 px), updated per sample
 unsigned long lastPowerUpdate = 0;
 float smoothedVoltage = 0;
 unsigned long lastChargeChange = 0;
@@ -99,14 +151,31 @@ unsigned long lastKeyPressTime = 0;
 char lastKey = 0;
 #define KEY_DEBOUNCE_TIME 200 // 200ms debounce time
 
-// RTC variables
-unsigned long systemBootTime = 0;
-unsigned long lockoutRealStartTime = 0;
+// Binary telemetry link
+uint16_t telemetrySeq = 0;
+unsigned long telemetryDroppedFrames = 0;  // Frames skipped because the TX buffer was full
+unsigned long reportedTelemetryDrops = 0;
+uint8_t telemetryFrame[TELEMETRY_MAX_FRAME];
+TelemetryEncoder telemetryEncoder;
+uint8_t telemetryBlock[TELEMETRY_MAX_PAYLOAD];
+unsigned long telemetryBlockStart = 0;
+
+// Screen state machine
+UiMachine ui;
+
+// Memory monitoring
+unsigned long lastMemoryCheck = 0;
+#define MEMORY_CHECK_INTERVAL 1000 // milliseconds between heap/stack checks
 
 // ===== Main Functions =====
 void setup()
 {
-    Serial.begin(115200);
+    if (TELEMETRY_BINARY)
+    {
+        Serial.setTxBufferSize(TELEMETRY_TX_BUFFER);
+    }
+    Serial.begin(SERIAL_BAUD);
+    telemetryEncoderBegin(telemetryEncoder, telemetryBlock, sizeof(telemetryBlock));
 
     // Initialize hardware
     pinMode(relay, OUTPUT);
@@ -117,22 +186,26 @@ void setup()
     oled.clear();
     oled.update();
 
-    // Initialize INA219
-    // if (!ina219.begin())
-    // {
-    //     Serial.println("Failed to find INA219 chip");
-    //     while (1)
-    //     {
-    //         delay(10);
-    //     }
-    // }
-    // ina219.setCalibration_32V_2A(); // Set calibration for better accuracy
+    // Initialize INA219 - without it the ADC path is the only voltage source
+    ina219Present = ina219.begin();
+    if (ina219Present)
+    {
+        ina219.setCalibration_32V_2A(); // Set calibration for better accuracy
+    }
+    else
+    {
+        textLog.println("Failed to find INA219 chip - using ADC pack voltage");
+    }
+
+    // Start continuous ADC sampling of the pack voltage divider
+    adcPresent = adcSamplerBegin();
 
     // Initialize EEPROM
     EEPROM.begin(EEPROM_SIZE);
     
-    // Initialize RTC and calculate boot time
-    initializeRTC();
+    // Start the monotonic/wall clock (restored from RTC memory if available)
+    timeServiceBegin();
+    sendTelemetryEvent(TELEMETRY_EVENT_BOOT, monotonicContinued() ? 1 : 0);
     
     // Load security state and check real-time lockout
     loadSecurityState();
@@ -140,32 +213,31 @@ void setup()
     // Configure keypad debouncing
     customKeypad.setDebounceTime(50);
 
-    // Show welcome screen
-    showWelcomeScreen();
-    delay(3000);
+    // Welcome screen is the first UI state; it times out from loop()
+    uiBegin(ui, millis());
 
     // Check if system is locked (with real-time consideration)
     checkLockoutStatus();
 
+    // Start energy rollups on the monotonic timeline
+    energyStatsBegin(monotonicMillis());
+
     // Initial power reading
     updatePowerData();
     smoothedVoltage = loadVoltage; // Initialize smoothed voltage
+
+    // Everything is allocated by now; from here on the heap must not grow
+    memoryGuardArm();
 }
 
 void loop()
 {
-    if (systemLocked)
-    {
-        handleLockoutScreen();
-    }
-    else if (!authenticated)
-    {
-        handlePinEntry();
-    }
-    else
-    {
-        handleHomeScreen();
-    }
+    timeServiceUpdate();
+    adcSamplerPoll();
+
+    // Advance the screen state machine, then redraw only if the view changed
+    updateUi();
+    renderUi();
 
     // Update power data every 500ms
     if (millis() - lastPowerUpdate > 500)
@@ -173,64 +245,34 @@ void loop()
         updatePowerData();
         lastPowerUpdate = millis();
     }
+
+    // Track heap and stack high-water marks
+    if (millis() - lastMemoryCheck > MEMORY_CHECK_INTERVAL)
+    {
+        checkMemory();
+        checkAdcOverruns();
+        checkTelemetryDrops();
+        lastMemoryCheck = millis();
+    }
     
     // Small delay to prevent excessive CPU usage
     delay(50);
 }
 
-// ===== RTC and Real-Time Functions =====
-void initializeRTC()
-{
-    // Get current system uptime as boot reference
-    systemBootTime = millis();
-    
-    // Try to get real time from NTP (optional - requires WiFi)
-    // For now, we'll use a simple elapsed time tracking system
-    
-    Serial.print("System boot time reference: ");
-    Serial.println(systemBootTime);
-}
-
-unsigned long getRealTimeSeconds()
-{
-    // This returns seconds since system boot
-    // In a full implementation, you'd get actual Unix timestamp
-    return (millis() - systemBootTime) / 1000;
-}
-
-void saveRealTimestamp()
-{
-    unsigned long currentRealTime = getRealTimeSeconds();
-    EEPROM.put(LOCKOUT_TIMESTAMP_ADDR, currentRealTime);
-    EEPROM.put(BOOT_TIMESTAMP_ADDR, systemBootTime);
-    EEPROM.commit();
-    
-    Serial.print("Saved real timestamp: ");
-    Serial.println(currentRealTime);
-}
-
-unsigned long loadRealTimestamp()
+// ===== Display Functions =====
+void drawBorder()
 {
-    unsigned long savedTimestamp;
-    unsigned long savedBootTime;
-    
-    EEPROM.get(LOCKOUT_TIMESTAMP_ADDR, savedTimestamp);
-    EEPROM.get(BOOT_TIMESTAMP_ADDR, savedBootTime);
-    
-    // If data is corrupted, return 0
-    if (savedTimestamp == 0xFFFFFFFF || savedBootTime == 0xFFFFFFFF)
-    {
-        return 0;
-    }
-    
-    return savedTimestamp;
+    // Four page-aligned copies instead of a stroked rect
+    oled.drawBitmap(0, 0, borderSprite(BORDER_TOP), BORDER_W, BORDER_EDGE_H, 0, BUF_REPLACE);
+    oled.drawBitmap(0, BORDER_EDGE_H, borderSprite(BORDER_SIDE), 1, BORDER_SIDE_H, 0, BUF_REPLACE);
+    oled.drawBitmap(BORDER_W - 1, BORDER_EDGE_H, borderSprite(BORDER_SIDE), 1, BORDER_SIDE_H, 0, BUF_REPLACE);
+    oled.drawBitmap(0, BORDER_H - BORDER_EDGE_H, borderSprite(BORDER_BOTTOM), BORDER_W, BORDER_EDGE_H, 0, BUF_REPLACE);
 }
 
-// ===== Display Functions =====
 void showWelcomeScreen()
 {
     oled.clear();
-    oled.rect(0, 0, 127, 63, OLED_STROKE);
+    drawBorder();
 
     // Center "Welcome to" (11 characters)
     int welcomeWidth = 11 * 6; // ~6 pixels per character
@@ -247,10 +289,10 @@ void showWelcomeScreen()
     oled.update();
 }
 
-void showPinEntryScreen(bool showAttempts)
+void showPinEntryScreen(const UiViewModel &view)
 {
     oled.clear();
-    oled.rect(0, 0, 127, 63, OLED_STROKE);
+    drawBorder();
     
     // Center "Enter your PIN:" (15 characters)
     int titleWidth = 15 * 6;
@@ -262,23 +304,23 @@ void showPinEntryScreen(bool showAttempts)
     int pinWidth = 4 * 8; // Wider spacing for PIN display
     int pinX = (128 - pinWidth) / 2;
     oled.setCursorXY(pinX, 30);
-    for (int i = 0; i < pinPosition; i++)
+    for (int i = 0; i < view.pinPosition; i++)
     {
         oled.print("* ");
     }
-    for (int i = pinPosition; i < 4; i++)
+    for (int i = view.pinPosition; i < 4; i++)
     {
         oled.print("- ");
     }
 
     // Only show attempts if requested (after first failed attempt)
-    if (showAttempts && failedAttempts > 0)
+    if (view.attemptsLeft > 0)
     {
         int attemptsWidth = 16 * 6; // Approximate width
         int attemptsX = (128 - attemptsWidth) / 2;
         oled.setCursorXY(attemptsX, 50);
         oled.print("Attempts left: ");
-        oled.print(MAX_ATTEMPTS - failedAttempts);
+        oled.print(view.attemptsLeft);
     }
 
     oled.update();
@@ -287,7 +329,7 @@ void showPinEntryScreen(bool showAttempts)
 void showAccessGranted()
 {
     oled.clear();
-    oled.rect(0, 0, 127, 63, OLED_STROKE);
+    drawBorder();
     
     // Center "Access Granted!" (15 characters)
     int titleWidth = 15 * 6;
@@ -296,13 +338,12 @@ void showAccessGranted()
     oled.print("Access Granted!");
     
     oled.update();
-    delay(2000);
 }
 
-void showAccessDenied()
+void showAccessDenied(const UiViewModel &view)
 {
     oled.clear();
-    oled.rect(0, 0, 127, 63, OLED_STROKE);
+    drawBorder();
     
     // Center "Incorrect PIN!" (14 characters)
     int titleWidth = 14 * 6;
@@ -311,15 +352,133 @@ void showAccessDenied()
     oled.print("Incorrect PIN!");
     
     // Center attempts message
-    String attemptsMsg = String(MAX_ATTEMPTS - failedAttempts);
-    attemptsMsg += " attempts left";
-    int msgWidth = attemptsMsg.length() * 6;
+    char attemptsMsg[20];
+    snprintf(attemptsMsg, sizeof(attemptsMsg), "%d attempts left", view.attemptsLeft);
+    int msgWidth = strlen(attemptsMsg) * 6;
     int msgX = (128 - msgWidth) / 2;
     oled.setCursorXY(msgX, 40);
     oled.print(attemptsMsg);
     
     oled.update();
-    delay(2000);
+}
+
+// ===== UI State Functions =====
+void updateUi()
+{
+    uint32_t now = millis();
+
+    switch (ui.state)
+    {
+        case UI_WELCOME:
+        case UI_DENIED:
+            if (uiTimedOut(ui, now))
+            {
+                dispatchUi(systemLocked ? UI_EVENT_LOCKED : UI_EVENT_TIMEOUT);
+            }
+            break;
+        case UI_GRANTED:
+            if (uiTimedOut(ui, now))
+            {
+                dispatchUi(UI_EVENT_TIMEOUT);
+            }
+            break;
+        case UI_PIN_ENTRY:
+            handlePinEntry();
+            break;
+        case UI_LOCKOUT:
+            checkLockoutExpiry();
+            break;
+        default:
+            break;
+    }
+}
+
+void dispatchUi(UiEvent event)
+{
+    UiState previous = ui.state;
+    if (!uiDispatch(ui, event, millis()))
+    {
+        return;
+    }
+
+    // Coming back from a failed attempt shows the attempts left straight away
+    if (ui.state == UI_PIN_ENTRY)
+    {
+        showAttemptsHint = previous == UI_DENIED;
+    }
+}
+
+void buildViewModel(UiViewModel &view)
+{
+    // Only the fields a screen shows are set, so nothing else triggers a redraw
+    view = UiViewModel{};
+    view.state = ui.state;
+
+    switch (ui.state)
+    {
+        case UI_PIN_ENTRY:
+            view.pinPosition = pinPosition;
+            if (showAttemptsHint && failedAttempts > 0)
+            {
+                view.attemptsLeft = MAX_ATTEMPTS - failedAttempts;
+            }
+            break;
+        case UI_DENIED:
+            view.attemptsLeft = failedAttempts < MAX_ATTEMPTS ? MAX_ATTEMPTS - failedAttempts : 0;
+            break;
+        case UI_LOCKOUT:
+        {
+            uint64_t now = monotonicMillis();
+            view.countdownSeconds = now < lockoutEndTime ? (uint16_t)((lockoutEndTime - now) / 1000) : 0;
+            break;
+        }
+        case UI_HOME:
+            view.percentage = (uint8_t)(constrain(batteryPercentage, 0, 100) + 0.5f);
+            view.fillLevel = batteryFillLevel;
+            view.charging = isCharging ? 1 : 0;
+            if (isCharging)
+            {
+                advanceChargingAnimation();
+                view.animFrame = chargingAnimFrame;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void renderUi()
+{
+    UiViewModel view;
+    buildViewModel(view);
+    if (!uiShouldRender(ui, view))
+    {
+        return;
+    }
+
+    switch (view.state)
+    {
+        case UI_WELCOME:
+            showWelcomeScreen();
+            break;
+        case UI_PIN_ENTRY:
+            showPinEntryScreen(view);
+            break;
+        case UI_GRANTED:
+            showAccessGranted();
+            break;
+        case UI_DENIED:
+            showAccessDenied(view);
+            break;
+        case UI_LOCKOUT:
+            showLockoutScreen(view);
+            break;
+        case UI_HOME:
+            showHomeScreen(view);
+            break;
+        default:
+            break;
+    }
 }
 
 // ===== Power Monitoring Functions =====
@@ -329,17 +488,30 @@ void updatePowerData()
     wasCharging = isCharging;
     
     // Read raw values
-    float shuntVoltage =  20; //ina219.getShuntVoltage_mV() / 1000.0; // Convert to volts
-    float busVoltage = 20; //ina219.getBusVoltage_V();
-    current_A =  10;//ina219.getCurrent_mA() / 1000.0;
-    power_W =  10; //ina219.getPower_mW() / 1000.0;
-    loadVoltage = busVoltage + shuntVoltage;
+    float shuntVoltage = 0;
+    if (ina219Present)
+    {
+        shuntVoltage = ina219.getShuntVoltage_mV() / 1000.0; // Convert to volts
+        float busVoltage = ina219.getBusVoltage_V();
+        current_A = ina219.getCurrent_mA() / 1000.0;
+        power_W = ina219.getPower_mW() / 1000.0;
+        loadVoltage = busVoltage + shuntVoltage;
+        crossCheckVoltage(loadVoltage);
+    }
+    else if (adcPresent && adcPackVoltageValid())
+    {
+        // Fallback: voltage only, no shunt to measure current through
+        loadVoltage = adcPackVoltage();
+        current_A = 0;
+        power_W = 0;
+    }
 
     // Apply exponential smoothing to voltage readings
     smoothedVoltage = smoothedVoltage * (1.0 - VOLTAGE_SMOOTHING) + loadVoltage * VOLTAGE_SMOOTHING;
 
     // Calculate battery percentage
     batteryPercentage = calculateBatteryPercentage(smoothedVoltage);
+    batteryFillLevel = map(constrain(batteryPercentage, 0, 100), 0, 100, 0, BATTERY_FILL_LEVELS - 1);
 
     // Detect charging state with faster response
     unsigned long now = millis();
@@ -362,14 +534,53 @@ void updatePowerData()
         {
             isCharging = newChargingState;
             lastChargeChange = now;
-            Serial.print("Charging state changed to: ");
-            Serial.println(isCharging ? "CHARGING" : "DISCHARGING");
+            textLog.print("Charging state changed to: ");
+            textLog.println(isCharging ? "CHARGING" : "DISCHARGING");
+            sendTelemetryEvent(TELEMETRY_EVENT_CHARGING, isCharging ? 1 : 0);
         }
     }
     else
     {
         lastChargeChange = now;
     }
+
+    // Fold the sample into the minute/hour/day energy rollups
+    energyStatsAddSample(monotonicMillis(), power_W, current_A, isCharging);
+    sendTelemetrySample();
+}
+
+void crossCheckVoltage(float inaVoltage)
+{
+    if (!adcPresent || !adcPackVoltageValid())
+    {
+        return;
+    }
+
+    // Report only when the sources start or stop disagreeing
+    float difference = inaVoltage - adcPackVoltage();
+    bool mismatch = fabs(difference) > ADC_CROSSCHECK_TOLERANCE;
+    if (mismatch != voltageMismatch)
+    {
+        voltageMismatch = mismatch;
+        textLog.print(mismatch ? "Voltage mismatch - INA219: " : "Voltage sources agree - INA219: ");
+        textLog.print(inaVoltage, 2);
+        textLog.print("V, ADC: ");
+        textLog.print(adcPackVoltage(), 2);
+        textLog.println("V");
+        sendTelemetryEvent(TELEMETRY_EVENT_SENSOR_MISMATCH, mismatch ? (int32_t)(difference * 1000) : 0);
+    }
+}
+
+void checkAdcOverruns()
+{
+    // The DMA buffer covers ADC_LOOP_BUDGET_MS; overruns mean the loop ran longer
+    uint32_t overruns = adcOverruns();
+    if (overruns != reportedAdcOverruns)
+    {
+        textLog.print("ADC: buffer overruns: ");
+        textLog.println(overruns);
+        reportedAdcOverruns = overruns;
+    }
 }
 
 float calculateBatteryPercentage(float voltage)
@@ -404,13 +615,13 @@ float mapFloat(float x, float in_min, float in_max, float out_min, float out_max
 }
 
 // ===== Home Screen Functions =====
-void handleHomeScreen()
+void showHomeScreen(const UiViewModel &view)
 {
     oled.clear();
-    oled.rect(0, 0, 127, 63, OLED_STROKE);
+    drawBorder();
 
     // Top row: Battery icon (left) and Current (right)
-    drawBatteryIcon();
+    drawBatteryIcon(view);
     
     // Current display (top right, aligned)
     // oled.setCursorXY(85, 5);
@@ -434,142 +645,54 @@ void handleHomeScreen()
     oled.update();
 }
 
-void drawBatteryIcon()
+void drawBatteryIcon(const UiViewModel &view)
 {
-    // Position battery icon at top left
+    // Position battery icon at top left, on a page boundary for a direct copy
     int batteryX = 5;
-    int batteryY = 5;
+    int batteryY = 8;
 
-    // Draw battery outline (slightly larger for better visibility)
-    oled.rect(batteryX, batteryY, batteryX + 32, batteryY + 12, OLED_STROKE);
-    oled.rect(batteryX + 32, batteryY + 4, batteryX + 35, batteryY + 8, OLED_FILL);
+    // Animated charging frames follow the static one in the atlas
+    uint8_t frame = view.charging ? BATTERY_FRAME_STATIC + 1 + view.animFrame : BATTERY_FRAME_STATIC;
 
-    // Calculate fill width based on battery percentage
-    int fillWidth = map(constrain(batteryPercentage, 0, 100), 0, 100, 0, 30);
-    
-    if (isCharging)
-    {
-        // Draw animated charging pattern
-        drawChargingAnimation();
-    }
-    else if (fillWidth > 0)
-    {
-        // Normal battery fill
-        oled.rect(batteryX + 1, batteryY + 1, batteryX + 1 + fillWidth, batteryY + 11, OLED_FILL);
-    }
+    // Outline, fill and charging effect are all pre-rendered in the sprite
+    oled.drawBitmap(batteryX, batteryY, batterySprite(frame, view.fillLevel),
+                    BATTERY_SPRITE_W, BATTERY_SPRITE_H, 0, BUF_REPLACE);
 
     // Display percentage text below icon with more space
     oled.setCursorXY(batteryX + 8, batteryY + 20);  // Increased vertical spacing
-    oled.print(batteryPercentage, 0);
+    oled.print(view.percentage);
     oled.print("%");
 }
 
-void drawChargingAnimation()
+void advanceChargingAnimation()
 {
-    int batteryX = 5;
-    int batteryY = 5;
-    int fillWidth = map(constrain(batteryPercentage, 0, 100), 0, 100, 0, 30);
-    
     // Update animation frame
     if (millis() - lastChargingAnimUpdate > CHARGING_ANIM_SPEED)
     {
         chargingAnimFrame = (chargingAnimFrame + 1) % 4;
         lastChargingAnimUpdate = millis();
     }
-    
-    // Draw base fill
-    if (fillWidth > 0)
-    {
-        oled.rect(batteryX + 1, batteryY + 1, batteryX + 1 + fillWidth, batteryY + 11, OLED_FILL);
-    }
-    
-    // Draw animated charging effect
-    switch (chargingAnimFrame)
-    {
-        case 0:
-            // Lightning bolt in center
-            oled.line(batteryX + 15, batteryY + 3, batteryX + 18, batteryY + 6, OLED_STROKE);
-            oled.line(batteryX + 18, batteryY + 6, batteryX + 14, batteryY + 6, OLED_STROKE);
-            oled.line(batteryX + 14, batteryY + 6, batteryX + 17, batteryY + 9, OLED_STROKE);
-            break;
-        case 1:
-            // Moving segments
-            for (int i = 0; i < 30; i += 6)
-            {
-                if (i < fillWidth)
-                {
-                    oled.line(batteryX + 1 + i, batteryY + 1, batteryX + 1 + i + 2, batteryY + 1, OLED_CLEAR);
-                }
-            }
-            break;
-        case 2:
-            // Lightning bolt slightly offset
-            oled.line(batteryX + 16, batteryY + 3, batteryX + 19, batteryY + 6, OLED_STROKE);
-            oled.line(batteryX + 19, batteryY + 6, batteryX + 15, batteryY + 6, OLED_STROKE);
-            oled.line(batteryX + 15, batteryY + 6, batteryX + 18, batteryY + 9, OLED_STROKE);
-            break;
-        case 3:
-            // Full fill with pulse effect
-            if (fillWidth < 30)
-            {
-                // Add extra segments to show charging progress
-                int extraWidth = min(5, 30 - fillWidth);
-                oled.rect(batteryX + 1 + fillWidth, batteryY + 1, 
-                         batteryX + 1 + fillWidth + extraWidth, batteryY + 11, OLED_FILL);
-            }
-            break;
-    }
 }
 
 // ===== Security Functions =====
 void checkLockoutStatus()
 {
-    if (failedAttempts >= MAX_ATTEMPTS && lockoutStartTime > 0)
+    if (failedAttempts >= MAX_ATTEMPTS && lockoutEndTime > 0)
     {
-        unsigned long currentTime = millis();
-        unsigned long elapsedTime;
-        
-        // Load the real timestamp when lockout started
-        unsigned long lockoutRealTime = loadRealTimestamp();
-        unsigned long currentRealTime = getRealTimeSeconds();
-        
-        // If we have a valid real timestamp, use it for more accurate tracking
-        if (lockoutRealTime > 0)
-        {
-            unsigned long realElapsedSeconds = currentRealTime - lockoutRealTime;
-            elapsedTime = realElapsedSeconds * 1000; // Convert to milliseconds
-            
-            Serial.print("Real-time lockout check - Elapsed: ");
-            Serial.print(realElapsedSeconds);
-            Serial.println(" seconds");
-        }
-        else
-        {
-            // Fallback to millis() based timing
-            if (currentTime >= lockoutStartTime)
-            {
-                elapsedTime = currentTime - lockoutStartTime;
-            }
-            else
-            {
-                // Overflow occurred
-                elapsedTime = (0xFFFFFFFF - lockoutStartTime) + currentTime + 1;
-            }
-        }
-        
-        if (elapsedTime < LOCKOUT_DURATION)
+        uint64_t now = monotonicMillis();
+
+        if (now < lockoutEndTime)
         {
             systemLocked = true;
-            Serial.println("System locked - lockout period active");
+            textLog.print("System locked - lockout period active, remaining: ");
+            textLog.print((unsigned long)((lockoutEndTime - now) / 1000));
+            textLog.println(" seconds");
         }
         else
         {
             // Lockout period expired - reset everything
-            Serial.println("Lockout period expired - resetting");
-            failedAttempts = 0;
-            lockoutStartTime = 0;
-            lockoutRealStartTime = 0;
-            systemLocked = false;
+            textLog.println("Lockout period expired - resetting");
+            clearLockout();
             saveSecurityState();
         }
     }
@@ -577,57 +700,48 @@ void checkLockoutStatus()
     {
         // Not locked
         systemLocked = false;
-        lockoutStartTime = 0;
-        lockoutRealStartTime = 0;
+        lockoutEndTime = 0;
+        lockoutWallStart = 0;
     }
 }
 
-void handleLockoutScreen()
+void startLockout()
 {
-    unsigned long currentTime = millis();
-    unsigned long elapsedTime;
-    
-    // Try to use real-time tracking first
-    unsigned long lockoutRealTime = loadRealTimestamp();
-    unsigned long currentRealTime = getRealTimeSeconds();
-    
-    if (lockoutRealTime > 0)
-    {
-        unsigned long realElapsedSeconds = currentRealTime - lockoutRealTime;
-        elapsedTime = realElapsedSeconds * 1000;
-    }
-    else
-    {
-        // Fallback to millis() timing
-        if (currentTime >= lockoutStartTime)
-        {
-            elapsedTime = currentTime - lockoutStartTime;
-        }
-        else
-        {
-            elapsedTime = (0xFFFFFFFF - lockoutStartTime) + currentTime + 1;
-        }
-    }
-    
-    // Check if lockout period has expired
-    if (elapsedTime >= LOCKOUT_DURATION)
+    lockoutEndTime = monotonicMillis() + LOCKOUT_DURATION;
+    lockoutWallStart = wallTimeSeconds();
+    systemLocked = true;
+}
+
+void clearLockout()
+{
+    failedAttempts = 0;
+    lockoutEndTime = 0;
+    lockoutWallStart = 0;
+    systemLocked = false;
+}
+
+void checkLockoutExpiry()
+{
+    // Lockout state is held in RAM - no flash reads on this path
+    if (monotonicMillis() < lockoutEndTime)
     {
-        systemLocked = false;
-        failedAttempts = 0;
-        lockoutStartTime = 0;
-        lockoutRealStartTime = 0;
-        saveSecurityState();
-        resetPinEntry();
-        showPinEntryScreen(false);
         return;
     }
-    
-    unsigned long remainingTime = LOCKOUT_DURATION - elapsedTime;
-    unsigned long minutes = remainingTime / 60000;
-    unsigned long seconds = (remainingTime % 60000) / 1000;
+
+    clearLockout();
+    saveSecurityState();
+    sendTelemetryEvent(TELEMETRY_EVENT_UNLOCK, 0);
+    resetPinEntry();
+    dispatchUi(UI_EVENT_UNLOCKED);
+}
+
+void showLockoutScreen(const UiViewModel &view)
+{
+    unsigned long minutes = view.countdownSeconds / 60;
+    unsigned long seconds = view.countdownSeconds % 60;
 
     oled.clear();
-    oled.rect(0, 0, 127, 63, OLED_STROKE);
+    drawBorder();
     
     // Center "System Locked" (13 characters)
     int titleWidth = 13 * 6;
@@ -642,11 +756,9 @@ void handleLockoutScreen()
     oled.print("Try again in");
     
     // Center countdown timer
-    String timeStr = String(minutes);
-    timeStr += ":";
-    if (seconds < 10) timeStr += "0";
-    timeStr += String(seconds);
-    int timeWidth = timeStr.length() * 6;
+    char timeStr[12];
+    snprintf(timeStr, sizeof(timeStr), "%lu:%02lu", minutes, seconds);
+    int timeWidth = strlen(timeStr) * 6;
     int timeX = (128 - timeWidth) / 2;
     oled.setCursorXY(timeX, 40);
     oled.print(timeStr);
@@ -654,6 +766,114 @@ void handleLockoutScreen()
     oled.update();
 }
 
+// ===== Telemetry Functions =====
+void sendTelemetryFrame(uint8_t type, const uint8_t *payload, uint16_t length)
+{
+    if (!TELEMETRY_BINARY)
+    {
+        return;
+    }
+
+    // Sequence advances even for dropped frames so the host can count the gap
+    size_t frameLength = telemetryBuildFrame(type, telemetrySeq++, payload, length, telemetryFrame);
+
+    // One block write into the UART TX buffer; never block the UI loop
+    if (frameLength == 0 || Serial.availableForWrite() < (int)frameLength)
+    {
+        telemetryDroppedFrames++;
+        return;
+    }
+    Serial.write(telemetryFrame, frameLength);
+}
+
+void checkTelemetryDrops()
+{
+    // Report the running total so the host can tell device-side drops from
+    // link losses. If this event is dropped too, the total changes and it
+    // goes out again on the next check.
+    if (telemetryDroppedFrames != reportedTelemetryDrops)
+    {
+        reportedTelemetryDrops = telemetryDroppedFrames;
+        sendTelemetryEvent(TELEMETRY_EVENT_TX_DROPPED, (int32_t)reportedTelemetryDrops);
+    }
+}
+
+void sendTelemetrySample()
+{
+    TelemetrySample sample;
+    sample.timeMs = (uint32_t)monotonicMillis();
+    sample.voltage = loadVoltage;
+    sample.current = current_A;
+    sample.power = power_W;
+
+    if (TELEMETRY_BINARY && TELEMETRY_COMPRESS)
+    {
+        addTelemetryBlockSample(sample);
+        return;
+    }
+
+    uint8_t payload[TELEMETRY_SAMPLE_PAYLOAD];
+    telemetryPackSample(sample, isCharging ? TELEMETRY_FLAG_CHARGING : 0, payload);
+    sendTelemetryFrame(TELEMETRY_PACKET_SAMPLE, payload, sizeof(payload));
+}
+
+void addTelemetryBlockSample(const TelemetrySample &sample)
+{
+    if (telemetryEncoder.count == 0)
+    {
+        telemetryBlockStart = millis();
+    }
+
+    if (!telemetryEncoderAdd(telemetryEncoder, sample))
+    {
+        // Block full: send it and start the next one with this sample
+        flushTelemetryBlock();
+        telemetryEncoderAdd(telemetryEncoder, sample);
+        telemetryBlockStart = millis();
+    }
+    else if (millis() - telemetryBlockStart >= TELEMETRY_BLOCK_FLUSH_MS)
+    {
+        flushTelemetryBlock();
+    }
+}
+
+void flushTelemetryBlock()
+{
+    if (telemetryEncoder.count > 0)
+    {
+        uint16_t length = telemetryEncoderFinish(telemetryEncoder);
+        sendTelemetryFrame(TELEMETRY_PACKET_BLOCK, telemetryBlock, length);
+    }
+    telemetryEncoderBegin(telemetryEncoder, telemetryBlock, sizeof(telemetryBlock));
+}
+
+void sendTelemetryEvent(uint8_t code, int32_t value)
+{
+    TelemetryEvent event;
+    event.timeMs = (uint32_t)monotonicMillis();
+    event.code = code;
+    event.value = value;
+
+    uint8_t payload[TELEMETRY_EVENT_PAYLOAD];
+    telemetryPackEvent(event, payload);
+    sendTelemetryFrame(TELEMETRY_PACKET_EVENT, payload, sizeof(payload));
+}
+
+// ===== Memory Functions =====
+void checkMemory()
+{
+    MemoryStats stats;
+    if (memoryGuardCheck(stats))
+    {
+        textLog.print("Memory low-water - heap free: ");
+        textLog.print(stats.heapMinFree);
+        textLog.print(" (at setup end: ");
+        textLog.print(stats.heapMinFreeAtArm);
+        textLog.print("), loop stack unused: ");
+        textLog.println(stats.stackHighWater);
+    }
+}
+
 // ===== PIN Entry Functions =====
 bool isValidKeyPress(char key)
 {
@@ -678,40 +898,39 @@ bool isValidKeyPress(char key)
 
 void handlePinEntry()
 {
-    static bool firstRun = true;
-    if (firstRun)
-    {
-        showPinEntryScreen(false); // Don't show attempts on first run
-        firstRun = false;
-    }
-
     char key = customKeypad.getKey();
     if (key && isValidKeyPress(key))
     {
-        Serial.print("Key pressed: ");
-        Serial.println(key);
+        textLog.print("Key pressed: ");
+        textLog.println(key);
         
         if (key == '#')
         {
             // Delete last digit (backspace)
             deleteLastDigit();
-            showPinEntryScreen(failedAttempts > 0);
+            pinCompleteTime = 0;
+            showAttemptsHint = true;
         }
         else if (isdigit(key) && pinPosition < 4)
         {
             // Add digit to PIN
             enteredPin[pinPosition] = key;
             pinPosition++;
-            showPinEntryScreen(failedAttempts > 0);
+            showAttemptsHint = true;
 
-            // Auto-submit when 4 digits entered
             if (pinPosition == 4)
             {
-                delay(500); // Brief pause to show complete PIN
-                verifyPin();
+                pinCompleteTime = millis();
             }
         }
     }
+
+    // Auto-submit once the complete PIN has been on screen briefly
+    if (pinPosition == 4 && pinCompleteTime > 0 && millis() - pinCompleteTime >= PIN_SUBMIT_DELAY)
+    {
+        pinCompleteTime = 0;
+        verifyPin();
+    }
 }
 
 void deleteLastDigit()
@@ -726,6 +945,7 @@ void deleteLastDigit()
 void resetPinEntry()
 {
     pinPosition = 0;
+    pinCompleteTime = 0;
     memset(enteredPin, '-', 4);
     enteredPin[4] = '\0';
 }
@@ -735,108 +955,125 @@ void verifyPin()
     // Null-terminate the entered PIN for comparison
     enteredPin[4] = '\0';
     
-    Serial.print("Verifying PIN: ");
+    textLog.print("Verifying PIN: ");
     for (int i = 0; i < 4; i++)
     {
-        Serial.print(enteredPin[i]);
+        textLog.print(enteredPin[i]);
     }
-    Serial.println();
+    textLog.println();
     
     if (strncmp(enteredPin, CORRECT_PIN, 4) == 0)
     {
         // Correct PIN
-        Serial.println("PIN correct - access granted");
+        textLog.println("PIN correct - access granted");
         authenticated = true;
-        failedAttempts = 0;
-        lockoutStartTime = 0;
-        lockoutRealStartTime = 0;
+        clearLockout();
         saveSecurityState();
-        showAccessGranted();
+        sendTelemetryEvent(TELEMETRY_EVENT_AUTH_OK, 0);
         digitalWrite(relay, HIGH);
+        dispatchUi(UI_EVENT_PIN_OK);
     }
     else
     {
         // Incorrect PIN
-        Serial.println("PIN incorrect - access denied");
+        textLog.println("PIN incorrect - access denied");
         failedAttempts++;
+        sendTelemetryEvent(TELEMETRY_EVENT_AUTH_FAIL, failedAttempts);
         
         if (failedAttempts >= MAX_ATTEMPTS)
         {
-            // Initiate lockout with real-time tracking
-            lockoutStartTime = millis();
-            lockoutRealStartTime = getRealTimeSeconds();
-            systemLocked = true;
+            // Initiate lockout on the monotonic clock
+            startLockout();
+            sendTelemetryEvent(TELEMETRY_EVENT_LOCKOUT, LOCKOUT_DURATION);
             
-            // Save the real timestamp
-            saveRealTimestamp();
-            
-            Serial.print("Lockout initiated at time: ");
-            Serial.print(lockoutStartTime);
-            Serial.print(" (real time: ");
-            Serial.print(lockoutRealStartTime);
-            Serial.println(")");
+            textLog.print("Lockout initiated, ends at: ");
+            textLog.print((unsigned long)(lockoutEndTime / 1000));
+            textLog.print("s (wall time: ");
+            textLog.print((long)lockoutWallStart);
+            textLog.println(")");
         }
         
         saveSecurityState();
-        showAccessDenied();
         resetPinEntry();
-        
-        if (failedAttempts < MAX_ATTEMPTS)
-        {
-            showPinEntryScreen(true); // Show attempts remaining
-        }
+        dispatchUi(UI_EVENT_PIN_BAD);
     }
 }
 
 // ===== EEPROM Functions =====
 void loadSecurityState()
 {
-    // Read failed attempts from EEPROM
-    EEPROM.get(ATTEMPTS_ADDR, failedAttempts);
-    
-    // Read lockout start time from EEPROM
-    EEPROM.get(LOCKOUT_START_ADDR, lockoutStartTime);
-    
-    // Read lockout active flag
-    uint8_t lockoutActive;
-    EEPROM.get(LOCKOUT_ACTIVE_ADDR, lockoutActive);
+    // Single flash read at boot; everything afterwards works on the RAM copy
+    EEPROM.get(SECURITY_RECORD_ADDR, securityCache);
 
-    // Validate loaded data
-    if (failedAttempts > MAX_ATTEMPTS || failedAttempts == 255)
+    // Validate loaded data (also catches erased flash and the old layout)
+    if (securityCache.version != SECURITY_RECORD_VERSION ||
+        securityCache.failedAttempts > MAX_ATTEMPTS ||
+        securityCache.lockoutActive > 1)
     {
-        failedAttempts = 0;
+        memset(&securityCache, 0, sizeof(securityCache));
+        securityCache.version = SECURITY_RECORD_VERSION;
     }
-    
-    // Check if lockout time is reasonable (not corrupted)
-    unsigned long currentTime = millis();
-    if (lockoutStartTime > currentTime + LOCKOUT_DURATION || lockoutStartTime == 0xFFFFFFFF)
+
+    failedAttempts = securityCache.failedAttempts;
+    systemLocked = securityCache.lockoutActive != 0;
+    lockoutEndTime = securityCache.lockoutEndTime;
+    lockoutWallStart = securityCache.lockoutWallStart;
+
+    if (systemLocked)
     {
-        lockoutStartTime = 0;
-        failedAttempts = 0;
+        uint64_t now = monotonicMillis();
+
+        if (monotonicContinued() && lockoutEndTime <= now + LOCKOUT_DURATION)
+        {
+            // Same timeline as when the lockout was stored - use it as is
+        }
+        else if (lockoutWallStart > 0 && wallTimeValid())
+        {
+            // New timeline, but wall time lets us carry the elapsed time over.
+            // Only reachable once SNTP has been started (see time_service.h)
+            int64_t elapsedMs = (wallTimeSeconds() - lockoutWallStart) * 1000;
+            if (elapsedMs < 0 || elapsedMs > LOCKOUT_DURATION)
+            {
+                elapsedMs = elapsedMs < 0 ? 0 : LOCKOUT_DURATION;
+            }
+            lockoutEndTime = now + (LOCKOUT_DURATION - elapsedMs);
+        }
+        else
+        {
+            // No way to know how long we were off - restart the full lockout
+            lockoutEndTime = now + LOCKOUT_DURATION;
+        }
+        saveSecurityState();
     }
     
-    Serial.print("Loaded state - Attempts: ");
-    Serial.print(failedAttempts);
-    Serial.print(", Lockout start: ");
-    Serial.println(lockoutStartTime);
+    textLog.print("Loaded state - Attempts: ");
+    textLog.print(failedAttempts);
+    textLog.print(", Locked: ");
+    textLog.println(systemLocked ? "yes" : "no");
 }
 
 void saveSecurityState()
 {
-    // Write failed attempts to EEPROM
-    EEPROM.put(ATTEMPTS_ADDR, failedAttempts);
-    
-    // Write lockout start time to EEPROM
-    EEPROM.put(LOCKOUT_START_ADDR, lockoutStartTime);
-    
-    // Write lockout active flag
-    uint8_t lockoutActive = systemLocked ? 1 : 0;
-    EEPROM.put(LOCKOUT_ACTIVE_ADDR, lockoutActive);
+    SecurityRecord record;
+    memset(&record, 0, sizeof(record));
+    record.version = SECURITY_RECORD_VERSION;
+    record.failedAttempts = failedAttempts;
+    record.lockoutActive = systemLocked ? 1 : 0;
+    record.lockoutEndTime = lockoutEndTime;
+    record.lockoutWallStart = lockoutWallStart;
+
+    // Write back only on change to spare flash wear
+    if (memcmp(&record, &securityCache, sizeof(record)) == 0)
+    {
+        return;
+    }
 
+    securityCache = record;
+    EEPROM.put(SECURITY_RECORD_ADDR, securityCache);
     EEPROM.commit();
     
-    Serial.print("Saved state - Attempts: ");
-    Serial.print(failedAttempts);
-    Serial.print(", Lockout start: ");
-    Serial.println(lockoutStartTime);
-}
\ No newline at end of file
+    textLog.print("Saved state - Attempts: ");
+    textLog.print(failedAttempts);
+    textLog.print(", Locked: ");
+    textLog.println(systemLocked ? "yes" : "no");
+}
@@ -0,0 +1,164 @@
+#include "memory_guard.h"
+
+#include <stdlib.h>
+#include <new>
+#include <esp_heap_caps.h>
+#include <esp_rom_sys.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static bool guardArmed = false;
+static uint32_t heapMinFreeAtArm = 0;
+static uint32_t lastHeapMinFree = UINT32_MAX;
+static uint32_t lastStackHighWater = UINT32_MAX;
+
+static void memoryGuardTrap(const char *what, uint32_t size)
+{
+    // ROM printf: must not allocate while reporting an allocation
+    esp_rom_printf("MEMORY GUARD: %s of %u bytes after setup()\n", what, (unsigned)size);
+    abort();
+}
+
+void memoryGuardArm()
+{
+    // Baseline on the low-water mark: temporary setup() allocations already lowered it
+    heapMinFreeAtArm = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    guardArmed = true;
+}
+
+bool memoryGuardCheck(MemoryStats &stats)
+{
+    stats.heapFree = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    stats.heapMinFree = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    stats.heapMinFreeAtArm = heapMinFreeAtArm;
+    stats.stackHighWater = uxTaskGetStackHighWaterMark(NULL) * sizeof(StackType_t);
+
+    if (STATIC_ALLOC && guardArmed && stats.heapMinFree + MEMORY_GUARD_HEAP_SLACK < heapMinFreeAtArm)
+    {
+        memoryGuardTrap("heap growth", heapMinFreeAtArm - stats.heapMinFree);
+    }
+
+    bool newLow = stats.heapMinFree < lastHeapMinFree || stats.stackHighWater < lastStackHighWater;
+    lastHeapMinFree = stats.heapMinFree;
+    lastStackHighWater = stats.stackHighWater;
+    return newLow;
+}
+
+#if STATIC_ALLOC
+// ===== Allocation Traps =====
+// The nothrow forms still trap after setup(), but report a failed malloc by
+// returning nullptr as their contract requires
+static void *guardedAlloc(size_t size, size_t alignment, bool nothrow)
+{
+    if (guardArmed)
+    {
+        memoryGuardTrap("operator new", size);
+    }
+    if (size == 0)
+    {
+        size = 1; // new of zero bytes must still return a unique pointer
+    }
+
+    void *ptr;
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+        ptr = aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+    else
+    {
+        ptr = malloc(size);
+    }
+    if (!ptr && !nothrow)
+    {
+        memoryGuardTrap("failed operator new", size);
+    }
+    return ptr;
+}
+
+void *operator new(size_t size)
+{
+    return guardedAlloc(size, 0, false);
+}
+
+void *operator new[](size_t size)
+{
+    return guardedAlloc(size, 0, false);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return guardedAlloc(size, 0, true);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return guardedAlloc(size, 0, true);
+}
+
+// C++17 over-aligned forms
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    return guardedAlloc(size, (size_t)alignment, false);
+}
+
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+    return guardedAlloc(size, (size_t)alignment, false);
+}
+
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return guardedAlloc(size, (size_t)alignment, true);
+}
+
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return guardedAlloc(size, (size_t)alignment, true);
+}
+
+// Pair with aligned_alloc() above; the sized and nothrow deletes forward here
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    free(ptr);
+}
+
+// C allocators, redirected here by -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+// in the static environment. This covers every malloc() in the link, including
+// the Arduino core and newlib. heap_caps_malloc() callers (FreeRTOS, IDF
+// drivers) are still only caught by the low-water check above.
+extern "C" void *__real_malloc(size_t size);
+extern "C" void *__real_calloc(size_t count, size_t size);
+extern "C" void *__real_realloc(void *ptr, size_t size);
+
+extern "C" void *__wrap_malloc(size_t size)
+{
+    if (guardArmed)
+    {
+        memoryGuardTrap("malloc", size);
+    }
+    return __real_malloc(size);
+}
+
+extern "C" void *__wrap_calloc(size_t count, size_t size)
+{
+    if (guardArmed)
+    {
+        memoryGuardTrap("calloc", count * size);
+    }
+    return __real_calloc(count, size);
+}
+
+extern "C" void *__wrap_realloc(void *ptr, size_t size)
+{
+    if (guardArmed)
+    {
+        memoryGuardTrap("realloc", size);
+    }
+    return __real_realloc(ptr, size);
+}
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+
+// ===== Memory Guard =====
+// Tracks heap and loop-task stack high-water marks. In static allocation
+// builds (-D STATIC_ALLOC=1) any new, malloc, calloc or realloc after setup()
+// traps, and so does the heap low-water mark dropping more than
+// MEMORY_GUARD_HEAP_SLACK below its end-of-setup value through other
+// allocators. The C allocators are only trapped when linked with
+// -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc.
+
+#ifndef STATIC_ALLOC
+#define STATIC_ALLOC 0
+#endif
+
+#define MEMORY_GUARD_HEAP_SLACK 2048  // Bytes the system tasks may still take
+
+struct MemoryStats
+{
+    uint32_t heapFree;
+    uint32_t heapMinFree;       // Lowest free heap since boot
+    uint32_t heapMinFreeAtArm;  // Lowest free heap at the end of setup()
+    uint32_t stackHighWater;    // Unused stack of the loop task (bytes)
+};
+
+void memoryGuardArm();
+bool memoryGuardCheck(MemoryStats &stats); // true when a new low-water mark was reached
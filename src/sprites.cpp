@@ -0,0 +1,193 @@
+#include "sprites.h"
+
+// Coordinates below are relative to the sprite origin and match the
+// rect()/line() calls the icon used to be drawn with.
+
+struct BatteryAtlas
+{
+    uint8_t sprites[BATTERY_FRAMES][BATTERY_FILL_LEVELS][BATTERY_SPRITE_BYTES];
+};
+
+struct BorderAtlas
+{
+    uint8_t top[BORDER_W * BORDER_EDGE_H / 8];
+    uint8_t bottom[BORDER_W * BORDER_EDGE_H / 8];
+    uint8_t side[BORDER_SIDE_H / 8];
+};
+
+// Drawing surface for one sprite; originY shifts it down the screen so a strip
+// can be cut out of a larger shape
+struct SpriteCanvas
+{
+    uint8_t *bytes;
+    int width;
+    int height;
+    int originY;
+
+    constexpr void dot(int x, int y, bool on)
+    {
+        y -= originY;
+        if (x < 0 || x >= width || y < 0 || y >= height)
+        {
+            return;
+        }
+        uint8_t &b = bytes[(y / 8) * width + x];
+        uint8_t mask = (uint8_t)(1 << (y % 8));
+        b = on ? (uint8_t)(b | mask) : (uint8_t)(b & ~mask);
+    }
+
+    constexpr void fillRect(int x0, int y0, int x1, int y1, bool on)
+    {
+        for (int x = x0; x <= x1; x++)
+        {
+            for (int y = y0; y <= y1; y++)
+            {
+                dot(x, y, on);
+            }
+        }
+    }
+
+    constexpr void strokeRect(int x0, int y0, int x1, int y1)
+    {
+        fillRect(x0, y0, x1, y0, true);
+        fillRect(x0, y1, x1, y1, true);
+        fillRect(x0, y0, x0, y1, true);
+        fillRect(x1, y0, x1, y1, true);
+    }
+
+    // Bresenham line
+    constexpr void line(int x0, int y0, int x1, int y1, bool on)
+    {
+        int dx = x1 > x0 ? x1 - x0 : x0 - x1;
+        int dy = y1 > y0 ? y0 - y1 : y1 - y0;
+        int sx = x0 < x1 ? 1 : -1;
+        int sy = y0 < y1 ? 1 : -1;
+        int err = dx + dy;
+        while (true)
+        {
+            dot(x0, y0, on);
+            if (x0 == x1 && y0 == y1)
+            {
+                break;
+            }
+            int e2 = 2 * err;
+            if (e2 >= dy)
+            {
+                err += dy;
+                x0 += sx;
+            }
+            if (e2 <= dx)
+            {
+                err += dx;
+                y0 += sy;
+            }
+        }
+    }
+
+    constexpr void bolt(int offset)
+    {
+        line(15 + offset, 3, 18 + offset, 6, true);
+        line(18 + offset, 6, 14 + offset, 6, true);
+        line(14 + offset, 6, 17 + offset, 9, true);
+    }
+};
+
+static constexpr void renderBattery(SpriteCanvas canvas, uint8_t frame, int fillWidth)
+{
+    // Outline and terminal nub
+    canvas.strokeRect(0, 0, 32, 12);
+    canvas.fillRect(32, 4, 35, 8, true);
+
+    // Level fill
+    if (fillWidth > 0)
+    {
+        canvas.fillRect(1, 1, 1 + fillWidth, 11, true);
+    }
+
+    switch (frame)
+    {
+        case 1:
+            // Lightning bolt in center
+            canvas.bolt(0);
+            break;
+        case 2:
+            // Moving segments
+            for (int i = 0; i < 30; i += 6)
+            {
+                if (i < fillWidth)
+                {
+                    canvas.line(1 + i, 1, 1 + i + 2, 1, false);
+                }
+            }
+            break;
+        case 3:
+            // Lightning bolt slightly offset
+            canvas.bolt(1);
+            break;
+        case 4:
+            // Extra segment to show charging progress
+            if (fillWidth < 30)
+            {
+                int extraWidth = 30 - fillWidth < 5 ? 30 - fillWidth : 5;
+                canvas.fillRect(1 + fillWidth, 1, 1 + fillWidth + extraWidth, 11, true);
+            }
+            break;
+    }
+}
+
+static constexpr BatteryAtlas buildBatteryAtlas()
+{
+    BatteryAtlas atlas{};
+    for (uint8_t frame = 0; frame < BATTERY_FRAMES; frame++)
+    {
+        for (int level = 0; level < BATTERY_FILL_LEVELS; level++)
+        {
+            renderBattery(SpriteCanvas{atlas.sprites[frame][level], BATTERY_SPRITE_W, BATTERY_SPRITE_H, 0},
+                          frame, level);
+        }
+    }
+    return atlas;
+}
+
+// Same outline as oled.rect(0, 0, 127, 63, OLED_STROKE), cut into page strips
+static constexpr BorderAtlas buildBorderAtlas()
+{
+    BorderAtlas atlas{};
+    SpriteCanvas top{atlas.top, BORDER_W, BORDER_EDGE_H, 0};
+    SpriteCanvas bottom{atlas.bottom, BORDER_W, BORDER_EDGE_H, BORDER_H - BORDER_EDGE_H};
+    SpriteCanvas side{atlas.side, 1, BORDER_SIDE_H, BORDER_EDGE_H};
+    top.strokeRect(0, 0, BORDER_W - 1, BORDER_H - 1);
+    bottom.strokeRect(0, 0, BORDER_W - 1, BORDER_H - 1);
+    side.strokeRect(0, 0, BORDER_W - 1, BORDER_H - 1);
+    return atlas;
+}
+
+// Placed in flash (.rodata) by the compiler; no runtime rendering
+static constexpr BatteryAtlas batteryAtlas = buildBatteryAtlas();
+static constexpr BorderAtlas borderAtlas = buildBorderAtlas();
+
+const uint8_t *batterySprite(uint8_t frame, uint8_t fillLevel)
+{
+    if (frame >= BATTERY_FRAMES)
+    {
+        frame = BATTERY_FRAME_STATIC;
+    }
+    if (fillLevel >= BATTERY_FILL_LEVELS)
+    {
+        fillLevel = BATTERY_FILL_LEVELS - 1;
+    }
+    return batteryAtlas.sprites[frame][fillLevel];
+}
+
+const uint8_t *borderSprite(BorderPart part)
+{
+    switch (part)
+    {
+        case BORDER_BOTTOM:
+            return borderAtlas.bottom;
+        case BORDER_SIDE:
+            return borderAtlas.side;
+        default:
+            return borderAtlas.top;
+    }
+}
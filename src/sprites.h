@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+
+// ===== Sprite Atlas =====
+// Battery icon and screen border sprites rendered at compile time in the SSH1106 page format
+// (one byte = 8 vertical pixels, columns left to right, one page after another),
+// so a frame is drawn with a single page-aligned drawBitmap() copy.
+
+#define BATTERY_SPRITE_W 36       // Outline (33 px) + terminal nub
+#define BATTERY_SPRITE_H 16       // Two display pages
+#define BATTERY_SPRITE_BYTES (BATTERY_SPRITE_W * BATTERY_SPRITE_H / 8)
+#define BATTERY_FILL_LEVELS 31    // Fill width 0..30 px
+#define BATTERY_FRAME_STATIC 0    // Plain fill; charging frames are 1..4
+#define BATTERY_FRAMES 5
+
+#define BORDER_W 128              // Screen frame drawn on every screen
+#define BORDER_H 64
+#define BORDER_EDGE_H 8           // Top and bottom strips are one page each
+#define BORDER_SIDE_H (BORDER_H - 2 * BORDER_EDGE_H)
+
+enum BorderPart : uint8_t
+{
+    BORDER_TOP = 0,     // BORDER_W x BORDER_EDGE_H at y = 0
+    BORDER_BOTTOM,      // BORDER_W x BORDER_EDGE_H at y = BORDER_H - BORDER_EDGE_H
+    BORDER_SIDE,        // 1 x BORDER_SIDE_H at x = 0 and x = BORDER_W - 1
+    BORDER_PART_COUNT
+};
+
+const uint8_t *batterySprite(uint8_t frame, uint8_t fillLevel);
+const uint8_t *borderSprite(BorderPart part);
@@ -0,0 +1,365 @@
+#include "telemetry_codec.h"
+
+#include <string.h>
+
+#define BLOCK_HEADER_BITS 16
+
+// ===== Bit Stream Helpers =====
+static void writeBits(TelemetryBits &bits, uint32_t value, uint8_t count)
+{
+    // MSB first
+    while (count > 0)
+    {
+        count--;
+        uint32_t byteIndex = bits.bitPos >> 3;
+        uint8_t mask = (uint8_t)(0x80 >> (bits.bitPos & 7));
+        if ((value >> count) & 1)
+        {
+            bits.buf[byteIndex] |= mask;
+        }
+        else
+        {
+            bits.buf[byteIndex] &= (uint8_t)~mask;
+        }
+        bits.bitPos++;
+    }
+}
+
+static bool readBits(TelemetryDecoder &dec, uint8_t count, uint32_t &value)
+{
+    if (dec.bitPos + count > (uint32_t)dec.length * 8)
+    {
+        return false;
+    }
+
+    value = 0;
+    while (count > 0)
+    {
+        count--;
+        uint8_t bit = (dec.buf[dec.bitPos >> 3] >> (7 - (dec.bitPos & 7))) & 1;
+        value = (value << 1) | bit;
+        dec.bitPos++;
+    }
+    return true;
+}
+
+static uint32_t floatBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bitsFloat(uint32_t bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static uint8_t leadingZeros(uint32_t value)
+{
+    return value == 0 ? 32 : (uint8_t)__builtin_clz(value);
+}
+
+static uint8_t trailingZeros(uint32_t value)
+{
+    return value == 0 ? 32 : (uint8_t)__builtin_ctz(value);
+}
+
+static void resetChannels(TelemetryChannelState *channels)
+{
+    for (uint8_t i = 0; i < TELEMETRY_CHANNELS; i++)
+    {
+        channels[i].prevBits = 0;
+        channels[i].leading = 0;
+        channels[i].trailing = 0xFF;
+    }
+}
+
+// ===== Encoder =====
+static void encodeTimestamp(TelemetryEncoder &enc, uint32_t timeMs)
+{
+    int32_t delta = (int32_t)(timeMs - enc.prevTime);
+    int32_t dod = (int32_t)((uint32_t)delta - (uint32_t)enc.prevDelta);
+    enc.prevTime = timeMs;
+    enc.prevDelta = delta;
+
+    if (dod == 0)
+    {
+        writeBits(enc.bits, 0x0, 1);
+    }
+    else if (dod >= -63 && dod <= 64)
+    {
+        writeBits(enc.bits, 0x2, 2);
+        writeBits(enc.bits, (uint32_t)dod & 0x7F, 7);
+    }
+    else if (dod >= -255 && dod <= 256)
+    {
+        writeBits(enc.bits, 0x6, 3);
+        writeBits(enc.bits, (uint32_t)dod & 0x1FF, 9);
+    }
+    else if (dod >= -2047 && dod <= 2048)
+    {
+        writeBits(enc.bits, 0xE, 4);
+        writeBits(enc.bits, (uint32_t)dod & 0xFFF, 12);
+    }
+    else
+    {
+        writeBits(enc.bits, 0xF, 4);
+        writeBits(enc.bits, (uint32_t)dod, 32);
+    }
+}
+
+static void encodeValue(TelemetryBits &bits, TelemetryChannelState &channel, float value)
+{
+    uint32_t current = floatBits(value);
+    uint32_t xorValue = current ^ channel.prevBits;
+    channel.prevBits = current;
+
+    if (xorValue == 0)
+    {
+        // Value repeated
+        writeBits(bits, 0x0, 1);
+        return;
+    }
+
+    uint8_t leading = leadingZeros(xorValue);
+    uint8_t trailing = trailingZeros(xorValue);
+    if (leading > 31)
+    {
+        leading = 31;
+    }
+
+    if (channel.trailing != 0xFF && leading >= channel.leading && trailing >= channel.trailing)
+    {
+        // Fits in the previous meaningful-bit window
+        uint8_t length = 32 - channel.leading - channel.trailing;
+        writeBits(bits, 0x2, 2);
+        writeBits(bits, xorValue >> channel.trailing, length);
+    }
+    else
+    {
+        // New window: 5 bits leading zeros, 5 bits length - 1, then the bits
+        uint8_t length = 32 - leading - trailing;
+        writeBits(bits, 0x3, 2);
+        writeBits(bits, leading, 5);
+        writeBits(bits, length - 1, 5);
+        writeBits(bits, xorValue >> trailing, length);
+        channel.leading = leading;
+        channel.trailing = trailing;
+    }
+}
+
+void telemetryEncoderBegin(TelemetryEncoder &enc, uint8_t *buf, uint16_t capacity)
+{
+    enc.bits.buf = buf;
+    enc.bits.capacity = capacity;
+    enc.bits.bitPos = BLOCK_HEADER_BITS;
+    enc.count = 0;
+    enc.prevTime = 0;
+    enc.prevDelta = 0;
+    resetChannels(enc.channels);
+}
+
+bool telemetryEncoderAdd(TelemetryEncoder &enc, const TelemetrySample &sample)
+{
+    // Only accept the sample if its worst case still fits, so a block is never torn
+    uint32_t capacityBits = (uint32_t)enc.bits.capacity * 8;
+    if (enc.count == 0xFFFF || enc.bits.bitPos + TELEMETRY_MAX_SAMPLE_BITS > capacityBits)
+    {
+        return false;
+    }
+
+    if (enc.count == 0)
+    {
+        // First sample is stored raw
+        writeBits(enc.bits, sample.timeMs, 32);
+        writeBits(enc.bits, floatBits(sample.voltage), 32);
+        writeBits(enc.bits, floatBits(sample.current), 32);
+        writeBits(enc.bits, floatBits(sample.power), 32);
+        enc.prevTime = sample.timeMs;
+        enc.channels[0].prevBits = floatBits(sample.voltage);
+        enc.channels[1].prevBits = floatBits(sample.current);
+        enc.channels[2].prevBits = floatBits(sample.power);
+    }
+    else
+    {
+        encodeTimestamp(enc, sample.timeMs);
+        encodeValue(enc.bits, enc.channels[0], sample.voltage);
+        encodeValue(enc.bits, enc.channels[1], sample.current);
+        encodeValue(enc.bits, enc.channels[2], sample.power);
+    }
+
+    enc.count++;
+    return true;
+}
+
+uint16_t telemetryEncoderFinish(TelemetryEncoder &enc)
+{
+    enc.bits.buf[0] = (uint8_t)(enc.count & 0xFF);
+    enc.bits.buf[1] = (uint8_t)(enc.count >> 8);
+
+    // Zero the padding bits of the last byte
+    uint8_t padding = (uint8_t)((8 - (enc.bits.bitPos & 7)) & 7);
+    writeBits(enc.bits, 0, padding);
+
+    return (uint16_t)(enc.bits.bitPos / 8);
+}
+
+// ===== Decoder =====
+static bool decodeTimestamp(TelemetryDecoder &dec, uint32_t &timeMs)
+{
+    uint32_t bit;
+    uint8_t prefix = 0;
+    while (prefix < 4)
+    {
+        if (!readBits(dec, 1, bit))
+        {
+            return false;
+        }
+        if (bit == 0)
+        {
+            break;
+        }
+        prefix++;
+    }
+
+    int32_t dod = 0;
+    uint32_t raw = 0;
+    switch (prefix)
+    {
+        case 0:
+            break;
+        case 1:
+            if (!readBits(dec, 7, raw)) return false;
+            dod = (int32_t)(raw << 25) >> 25;
+            break;
+        case 2:
+            if (!readBits(dec, 9, raw)) return false;
+            dod = (int32_t)(raw << 23) >> 23;
+            break;
+        case 3:
+            if (!readBits(dec, 12, raw)) return false;
+            dod = (int32_t)(raw << 20) >> 20;
+            break;
+        default:
+            if (!readBits(dec, 32, raw)) return false;
+            dod = (int32_t)raw;
+            break;
+    }
+
+    // The 7/9/12-bit ranges are asymmetric, so the top value wraps to negative
+    if (prefix == 1 && dod == -64) dod = 64;
+    if (prefix == 2 && dod == -256) dod = 256;
+    if (prefix == 3 && dod == -2048) dod = 2048;
+
+    dec.prevDelta = (int32_t)((uint32_t)dec.prevDelta + (uint32_t)dod);
+    dec.prevTime += (uint32_t)dec.prevDelta;
+    timeMs = dec.prevTime;
+    return true;
+}
+
+static bool decodeValue(TelemetryDecoder &dec, TelemetryChannelState &channel, float &value)
+{
+    uint32_t bit;
+    if (!readBits(dec, 1, bit))
+    {
+        return false;
+    }
+
+    if (bit == 1)
+    {
+        uint32_t xorValue;
+        if (!readBits(dec, 1, bit))
+        {
+            return false;
+        }
+
+        if (bit == 1)
+        {
+            uint32_t leading, length;
+            if (!readBits(dec, 5, leading) || !readBits(dec, 5, length))
+            {
+                return false;
+            }
+            if (leading + length + 1 > 32)
+            {
+                return false; // Corrupt window, the shift below would be undefined
+            }
+            channel.leading = (uint8_t)leading;
+            channel.trailing = (uint8_t)(32 - leading - (length + 1));
+        }
+        else if (channel.trailing == 0xFF)
+        {
+            return false; // Window reuse before any window was sent
+        }
+
+        uint8_t length = 32 - channel.leading - channel.trailing;
+        if (!readBits(dec, length, xorValue))
+        {
+            return false;
+        }
+        channel.prevBits ^= xorValue << channel.trailing;
+    }
+
+    value = bitsFloat(channel.prevBits);
+    return true;
+}
+
+bool telemetryDecoderBegin(TelemetryDecoder &dec, const uint8_t *buf, uint16_t length)
+{
+    if (length < 2)
+    {
+        return false;
+    }
+
+    dec.buf = buf;
+    dec.length = length;
+    dec.bitPos = BLOCK_HEADER_BITS;
+    dec.count = (uint16_t)(buf[0] | (buf[1] << 8));
+    dec.index = 0;
+    dec.prevTime = 0;
+    dec.prevDelta = 0;
+    resetChannels(dec.channels);
+    return true;
+}
+
+bool telemetryDecoderNext(TelemetryDecoder &dec, TelemetrySample &sample)
+{
+    if (dec.index >= dec.count)
+    {
+        return false;
+    }
+
+    if (dec.index == 0)
+    {
+        uint32_t raw[4];
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            if (!readBits(dec, 32, raw[i]))
+            {
+                return false;
+            }
+        }
+        dec.prevTime = raw[0];
+        for (uint8_t i = 0; i < TELEMETRY_CHANNELS; i++)
+        {
+            dec.channels[i].prevBits = raw[i + 1];
+        }
+        sample.timeMs = raw[0];
+        sample.voltage = bitsFloat(raw[1]);
+        sample.current = bitsFloat(raw[2]);
+        sample.power = bitsFloat(raw[3]);
+    }
+    else if (!decodeTimestamp(dec, sample.timeMs) ||
+             !decodeValue(dec, dec.channels[0], sample.voltage) ||
+             !decodeValue(dec, dec.channels[1], sample.current) ||
+             !decodeValue(dec, dec.channels[2], sample.power))
+    {
+        return false;
+    }
+
+    dec.index++;
+    return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+
+// ===== Telemetry Codec =====
+// Gorilla-style block compression for power samples: delta-of-delta
+// timestamps and XOR-compressed floats. The encoder only writes into the
+// caller's buffer and never allocates; the decoder builds on the host too.
+//
+// Block layout: uint16 sample count (little endian), then the bit stream.
+
+#define TELEMETRY_CHANNELS 3              // voltage, current, power
+#define TELEMETRY_MAX_SAMPLE_BITS 168     // Worst case for one sample after the first
+
+struct TelemetrySample
+{
+    uint32_t timeMs;
+    float voltage;
+    float current;
+    float power;
+};
+
+struct TelemetryBits
+{
+    uint8_t *buf;
+    uint16_t capacity;  // Bytes
+    uint32_t bitPos;
+};
+
+struct TelemetryChannelState
+{
+    uint32_t prevBits;
+    uint8_t leading;
+    uint8_t trailing;   // 0xFF until a window has been sent
+};
+
+struct TelemetryEncoder
+{
+    TelemetryBits bits;
+    uint16_t count;
+    uint32_t prevTime;
+    int32_t prevDelta;
+    TelemetryChannelState channels[TELEMETRY_CHANNELS];
+};
+
+struct TelemetryDecoder
+{
+    const uint8_t *buf;
+    uint16_t length;    // Bytes
+    uint32_t bitPos;
+    uint16_t count;
+    uint16_t index;
+    uint32_t prevTime;
+    int32_t prevDelta;
+    TelemetryChannelState channels[TELEMETRY_CHANNELS];
+};
+
+void telemetryEncoderBegin(TelemetryEncoder &enc, uint8_t *buf, uint16_t capacity);
+bool telemetryEncoderAdd(TelemetryEncoder &enc, const TelemetrySample &sample); // false when the block is full
+uint16_t telemetryEncoderFinish(TelemetryEncoder &enc);                        // Block size in bytes
+
+bool telemetryDecoderBegin(TelemetryDecoder &dec, const uint8_t *buf, uint16_t length);
+bool telemetryDecoderNext(TelemetryDecoder &dec, TelemetrySample &sample);
@@ -0,0 +1,210 @@
+#include "telemetry_protocol.h"
+
+#include <string.h>
+
+// ===== Little-endian Helpers =====
+static void putU16(uint8_t *out, uint16_t value)
+{
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static void putU32(uint8_t *out, uint32_t value)
+{
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static void putFloat(uint8_t *out, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putU32(out, bits);
+}
+
+static uint16_t getU16(const uint8_t *in)
+{
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t getU32(const uint8_t *in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+static float getFloat(const uint8_t *in)
+{
+    uint32_t bits = getU32(in);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// ===== CRC and COBS =====
+uint16_t telemetryCrc16(const uint8_t *data, size_t length)
+{
+    // CRC-16/CCITT-FALSE: poly 0x1021, init 0xFFFF
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+size_t cobsEncode(const uint8_t *in, size_t length, uint8_t *out)
+{
+    size_t write = 1;
+    size_t codeIndex = 0;
+    uint8_t code = 1;
+
+    for (size_t read = 0; read < length; read++)
+    {
+        if (in[read] == 0)
+        {
+            out[codeIndex] = code;
+            code = 1;
+            codeIndex = write++;
+        }
+        else
+        {
+            out[write++] = in[read];
+            code++;
+            if (code == 0xFF)
+            {
+                out[codeIndex] = code;
+                code = 1;
+                codeIndex = write++;
+            }
+        }
+    }
+    out[codeIndex] = code;
+    return write;
+}
+
+size_t cobsDecode(const uint8_t *in, size_t length, uint8_t *out)
+{
+    size_t read = 0;
+    size_t write = 0;
+
+    while (read < length)
+    {
+        uint8_t code = in[read];
+        if (code == 0 || read + code > length)
+        {
+            return 0;
+        }
+        read++;
+
+        for (uint8_t i = 1; i < code; i++)
+        {
+            if (in[read] == 0)
+            {
+                return 0;
+            }
+            out[write++] = in[read++];
+        }
+        if (code != 0xFF && read != length)
+        {
+            out[write++] = 0;
+        }
+    }
+    return write;
+}
+
+// ===== Framing =====
+size_t telemetryBuildFrame(uint8_t type, uint16_t seq, const uint8_t *payload, uint16_t length, uint8_t *out)
+{
+    if (length > TELEMETRY_MAX_PAYLOAD)
+    {
+        return 0;
+    }
+
+    uint8_t packet[TELEMETRY_MAX_PACKET];
+    packet[0] = type;
+    putU16(packet + 1, seq);
+    memcpy(packet + 3, payload, length);
+    putU16(packet + 3 + length, telemetryCrc16(packet, 3 + length));
+
+    out[0] = 0x00;
+    size_t encoded = cobsEncode(packet, 5 + length, out + 1);
+    out[1 + encoded] = 0x00;
+    return encoded + 2;
+}
+
+bool telemetryParseFrame(const uint8_t *frame, size_t length, uint8_t *scratch, TelemetryPacket &packet)
+{
+    if (length == 0 || length > TELEMETRY_MAX_FRAME)
+    {
+        return false;
+    }
+
+    size_t decoded = cobsDecode(frame, length, scratch);
+    if (decoded < 5)
+    {
+        return false;
+    }
+    if (telemetryCrc16(scratch, decoded - 2) != getU16(scratch + decoded - 2))
+    {
+        return false;
+    }
+
+    packet.type = scratch[0];
+    packet.seq = getU16(scratch + 1);
+    packet.payload = scratch + 3;
+    packet.length = (uint16_t)(decoded - 5);
+    return true;
+}
+
+// ===== Payloads =====
+size_t telemetryPackSample(const TelemetrySample &sample, uint8_t flags, uint8_t *out)
+{
+    putU32(out, sample.timeMs);
+    putFloat(out + 4, sample.voltage);
+    putFloat(out + 8, sample.current);
+    putFloat(out + 12, sample.power);
+    out[16] = flags;
+    return TELEMETRY_SAMPLE_PAYLOAD;
+}
+
+size_t telemetryPackEvent(const TelemetryEvent &event, uint8_t *out)
+{
+    putU32(out, event.timeMs);
+    out[4] = event.code;
+    putU32(out + 5, (uint32_t)event.value);
+    return TELEMETRY_EVENT_PAYLOAD;
+}
+
+bool telemetryUnpackSample(const TelemetryPacket &packet, TelemetrySample &sample, uint8_t &flags)
+{
+    if (packet.type != TELEMETRY_PACKET_SAMPLE || packet.length != TELEMETRY_SAMPLE_PAYLOAD)
+    {
+        return false;
+    }
+
+    sample.timeMs = getU32(packet.payload);
+    sample.voltage = getFloat(packet.payload + 4);
+    sample.current = getFloat(packet.payload + 8);
+    sample.power = getFloat(packet.payload + 12);
+    flags = packet.payload[16];
+    return true;
+}
+
+bool telemetryUnpackEvent(const TelemetryPacket &packet, TelemetryEvent &event)
+{
+    if (packet.type != TELEMETRY_PACKET_EVENT || packet.length != TELEMETRY_EVENT_PAYLOAD)
+    {
+        return false;
+    }
+
+    event.timeMs = getU32(packet.payload);
+    event.code = packet.payload[4];
+    event.value = (int32_t)getU32(packet.payload + 5);
+    return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "telemetry_codec.h"
+
+// ===== Binary Telemetry Protocol =====
+// Packet: type (u8) | sequence (u16) | payload | CRC-16/CCITT (u16), all
+// little endian. Each packet is COBS-encoded and framed by 0x00 bytes on both
+// sides, so stray text on the line only ever corrupts itself.
+
+#define TELEMETRY_PACKET_SAMPLE 0x01  // One live sample
+#define TELEMETRY_PACKET_EVENT 0x02   // State change
+#define TELEMETRY_PACKET_BLOCK 0x03   // telemetry_codec block
+
+#define TELEMETRY_SAMPLE_PAYLOAD 17
+#define TELEMETRY_EVENT_PAYLOAD 9
+#define TELEMETRY_MAX_PAYLOAD 252
+#define TELEMETRY_MAX_PACKET (TELEMETRY_MAX_PAYLOAD + 5)
+#define TELEMETRY_MAX_FRAME (TELEMETRY_MAX_PACKET + TELEMETRY_MAX_PACKET / 254 + 3)
+
+#define TELEMETRY_FLAG_CHARGING 0x01
+
+// Event codes
+#define TELEMETRY_EVENT_BOOT 1
+#define TELEMETRY_EVENT_CHARGING 2      // value: 1 = charging, 0 = discharging
+#define TELEMETRY_EVENT_AUTH_OK 3
+#define TELEMETRY_EVENT_AUTH_FAIL 4     // value: failed attempts so far
+#define TELEMETRY_EVENT_LOCKOUT 5       // value: lockout duration (ms)
+#define TELEMETRY_EVENT_UNLOCK 6
+#define TELEMETRY_EVENT_SENSOR_MISMATCH 7 // value: INA219 minus ADC (mV), 0 when back in agreement
+#define TELEMETRY_EVENT_TX_DROPPED 8      // value: frames skipped on the device since boot
+
+struct TelemetryEvent
+{
+    uint32_t timeMs;
+    uint8_t code;
+    int32_t value;
+};
+
+struct TelemetryPacket
+{
+    uint8_t type;
+    uint16_t seq;
+    const uint8_t *payload;
+    uint16_t length;
+};
+
+uint16_t telemetryCrc16(const uint8_t *data, size_t length);
+size_t cobsEncode(const uint8_t *in, size_t length, uint8_t *out);
+size_t cobsDecode(const uint8_t *in, size_t length, uint8_t *out); // 0 on malformed input
+
+// Builds a complete 0x00-delimited frame into out (TELEMETRY_MAX_FRAME bytes)
+size_t telemetryBuildFrame(uint8_t type, uint16_t seq, const uint8_t *payload, uint16_t length, uint8_t *out);
+// Parses the bytes between two delimiters; packet.payload points into scratch
+bool telemetryParseFrame(const uint8_t *frame, size_t length, uint8_t *scratch, TelemetryPacket &packet);
+
+size_t telemetryPackSample(const TelemetrySample &sample, uint8_t flags, uint8_t *out);
+size_t telemetryPackEvent(const TelemetryEvent &event, uint8_t *out);
+bool telemetryUnpackSample(const TelemetryPacket &packet, TelemetrySample &sample, uint8_t &flags);
+bool telemetryUnpackEvent(const TelemetryPacket &packet, TelemetryEvent &event);
@@ -0,0 +1,22 @@
+#include "text_log.h"
+
+#if TELEMETRY_BINARY
+class NullLog : public Print
+{
+public:
+    size_t write(uint8_t) override
+    {
+        return 1;
+    }
+
+    size_t write(const uint8_t *, size_t size) override
+    {
+        return size;
+    }
+};
+
+static NullLog nullLog;
+Print &textLog = nullLog;
+#else
+Print &textLog = Serial;
+#endif
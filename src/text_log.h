@@ -0,0 +1,14 @@
+#pragma once
+
+#include <Arduino.h>
+
+// ===== Text Log =====
+// Human-readable serial log. Build with -D TELEMETRY_BINARY=1 to replace it
+// with COBS-framed binary packets (see telemetry_protocol.h); the text is then
+// discarded here so it never lands between frames.
+
+#ifndef TELEMETRY_BINARY
+#define TELEMETRY_BINARY 0
+#endif
+
+extern Print &textLog;
@@ -0,0 +1,108 @@
+#include "time_service.h"
+
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_timer.h>
+#include <time.h>
+
+#include "text_log.h"
+
+#define TIME_RTC_MAGIC 0x54494D45 // "TIME"
+
+// Kept in RTC slow memory: survives deep sleep and soft resets, lost on power-on
+struct TimeRtcState
+{
+    uint32_t magic;
+    uint32_t check;
+    uint64_t lastMonoMs;    // Last monotonic value seen before reset/sleep
+    int64_t wallOffsetMs;   // Wall time (ms) minus monotonic time (ms)
+    uint8_t wallSynced;
+};
+
+RTC_NOINIT_ATTR static TimeRtcState rtcTime;
+
+static uint64_t monoBaseMs = 0;    // Monotonic value at esp_timer zero for this boot
+static bool continuedFromRtc = false;
+
+static uint32_t rtcChecksum(const TimeRtcState &state)
+{
+    uint32_t sum = state.magic;
+    sum = (sum << 5 | sum >> 27) ^ (uint32_t)state.lastMonoMs;
+    sum = (sum << 5 | sum >> 27) ^ (uint32_t)(state.lastMonoMs >> 32);
+    sum = (sum << 5 | sum >> 27) ^ (uint32_t)state.wallOffsetMs;
+    sum = (sum << 5 | sum >> 27) ^ (uint32_t)((uint64_t)state.wallOffsetMs >> 32);
+    sum = (sum << 5 | sum >> 27) ^ state.wallSynced;
+    return ~sum;
+}
+
+static void sealRtcState()
+{
+    rtcTime.check = rtcChecksum(rtcTime);
+}
+
+void timeServiceBegin()
+{
+    if (rtcTime.magic == TIME_RTC_MAGIC && rtcTime.check == rtcChecksum(rtcTime))
+    {
+        // Continue counting from where the previous boot left off
+        monoBaseMs = rtcTime.lastMonoMs;
+        continuedFromRtc = true;
+    }
+    else
+    {
+        // Cold boot - start a fresh timeline
+        rtcTime.magic = TIME_RTC_MAGIC;
+        rtcTime.lastMonoMs = 0;
+        rtcTime.wallOffsetMs = 0;
+        rtcTime.wallSynced = 0;
+        monoBaseMs = 0;
+        continuedFromRtc = false;
+    }
+
+    timeServiceUpdate();
+
+    textLog.print("Time service started - monotonic: ");
+    textLog.print((unsigned long)(monotonicMillis() / 1000));
+    textLog.print("s, continued: ");
+    textLog.println(continuedFromRtc ? "yes" : "no");
+}
+
+void timeServiceUpdate()
+{
+    uint64_t now = monotonicMillis();
+    rtcTime.lastMonoMs = now;
+
+    // Re-anchor wall time whenever the system clock holds an SNTP-synced value
+    time_t wallNow = time(nullptr);
+    if ((int64_t)wallNow >= WALL_TIME_MIN_VALID)
+    {
+        rtcTime.wallOffsetMs = (int64_t)wallNow * 1000 - (int64_t)now;
+        rtcTime.wallSynced = 1;
+    }
+
+    sealRtcState();
+}
+
+uint64_t monotonicMillis()
+{
+    return monoBaseMs + (uint64_t)(esp_timer_get_time() / 1000);
+}
+
+bool wallTimeValid()
+{
+    return rtcTime.wallSynced != 0;
+}
+
+int64_t wallTimeSeconds()
+{
+    if (!wallTimeValid())
+    {
+        return 0;
+    }
+    return ((int64_t)monotonicMillis() + rtcTime.wallOffsetMs) / 1000;
+}
+
+bool monotonicContinued()
+{
+    return continuedFromRtc;
+}
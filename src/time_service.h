@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+
+// ===== Time Service =====
+// 64-bit monotonic clock (milliseconds) that keeps counting across soft
+// resets, plus wall-clock time once the system clock has been set.
+// The state lives in RTC memory, so no flash access is needed to read it.
+// This firmware never connects WiFi or calls configTime(), so wall time
+// only becomes valid if something else starts SNTP.
+
+#define WALL_TIME_MIN_VALID 1600000000LL // Anything before Sep 2020 means "not synced"
+
+void timeServiceBegin();
+void timeServiceUpdate();
+
+uint64_t monotonicMillis();
+bool wallTimeValid();
+int64_t wallTimeSeconds(); // Unix seconds, or 0 if not synced
+bool monotonicContinued(); // true if the clock survived the last reset
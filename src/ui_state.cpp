@@ -0,0 +1,147 @@
+#include "ui_state.h"
+
+static constexpr UiTransition transitions[] = {
+    {UI_WELCOME, UI_EVENT_TIMEOUT, UI_PIN_ENTRY},
+    {UI_WELCOME, UI_EVENT_LOCKED, UI_LOCKOUT},
+    {UI_PIN_ENTRY, UI_EVENT_PIN_OK, UI_GRANTED},
+    {UI_PIN_ENTRY, UI_EVENT_PIN_BAD, UI_DENIED},
+    {UI_GRANTED, UI_EVENT_TIMEOUT, UI_HOME},
+    {UI_DENIED, UI_EVENT_TIMEOUT, UI_PIN_ENTRY},
+    {UI_DENIED, UI_EVENT_LOCKED, UI_LOCKOUT},
+    {UI_LOCKOUT, UI_EVENT_UNLOCKED, UI_PIN_ENTRY},
+};
+
+// How long each state shows before it raises UI_EVENT_TIMEOUT (0 = never)
+static constexpr uint32_t stateTimeouts[UI_STATE_COUNT] = {
+    UI_WELCOME_DURATION, // UI_WELCOME
+    0,                   // UI_PIN_ENTRY
+    UI_MESSAGE_DURATION, // UI_GRANTED
+    UI_MESSAGE_DURATION, // UI_DENIED
+    0,                   // UI_LOCKOUT
+    0,                   // UI_HOME
+};
+
+struct UiTransitionTable
+{
+    UiState next[UI_STATE_COUNT][UI_EVENT_COUNT];
+};
+
+// Expand the transition list into a direct [state][event] lookup at compile time
+static constexpr UiTransitionTable buildTransitionTable()
+{
+    UiTransitionTable table{};
+    for (uint8_t state = 0; state < UI_STATE_COUNT; state++)
+    {
+        for (uint8_t event = 0; event < UI_EVENT_COUNT; event++)
+        {
+            table.next[state][event] = UI_STATE_COUNT;
+        }
+    }
+    for (const UiTransition &transition : transitions)
+    {
+        table.next[transition.from][transition.event] = transition.to;
+    }
+    return table;
+}
+
+static constexpr UiTransitionTable transitionTable = buildTransitionTable();
+
+// Every listed transition must end up in the lookup (no duplicate state/event
+// pairs), and every timed state must have a timeout transition
+static constexpr bool transitionTableValid()
+{
+    for (const UiTransition &transition : transitions)
+    {
+        if (transitionTable.next[transition.from][transition.event] != transition.to)
+        {
+            return false;
+        }
+    }
+    for (uint8_t state = 0; state < UI_STATE_COUNT; state++)
+    {
+        if (stateTimeouts[state] > 0 && transitionTable.next[state][UI_EVENT_TIMEOUT] == UI_STATE_COUNT)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(transitionTableValid(), "transition table");
+
+void uiBegin(UiMachine &ui, uint32_t nowMs)
+{
+    ui.state = UI_WELCOME;
+    ui.enteredAtMs = nowMs;
+    ui.renderedValid = false;
+    ui.redraws = 0;
+}
+
+UiState uiNextState(UiState state, UiEvent event)
+{
+    if (state >= UI_STATE_COUNT || event >= UI_EVENT_COUNT)
+    {
+        return UI_STATE_COUNT;
+    }
+    return transitionTable.next[state][event];
+}
+
+bool uiDispatch(UiMachine &ui, UiEvent event, uint32_t nowMs)
+{
+    UiState next = uiNextState(ui.state, event);
+    if (next == UI_STATE_COUNT)
+    {
+        return false;
+    }
+
+    ui.state = next;
+    ui.enteredAtMs = nowMs;
+    return true;
+}
+
+bool uiTimedOut(const UiMachine &ui, uint32_t nowMs)
+{
+    uint32_t timeout = stateTimeouts[ui.state];
+    return timeout > 0 && nowMs - ui.enteredAtMs >= timeout;
+}
+
+static bool sameView(const UiViewModel &a, const UiViewModel &b)
+{
+    return a.state == b.state &&
+           a.pinPosition == b.pinPosition &&
+           a.attemptsLeft == b.attemptsLeft &&
+           a.percentage == b.percentage &&
+           a.fillLevel == b.fillLevel &&
+           a.charging == b.charging &&
+           a.animFrame == b.animFrame &&
+           a.countdownSeconds == b.countdownSeconds;
+}
+
+bool uiShouldRender(UiMachine &ui, const UiViewModel &view)
+{
+    if (ui.renderedValid && sameView(ui.rendered, view))
+    {
+        return false;
+    }
+
+    ui.rendered = view;
+    ui.renderedValid = true;
+    ui.redraws++;
+    return true;
+}
+
+uint8_t uiTransitionCount()
+{
+    return sizeof(transitions) / sizeof(transitions[0]);
+}
+
+bool uiGetTransition(uint8_t index, UiTransition &out)
+{
+    if (index >= uiTransitionCount())
+    {
+        return false;
+    }
+
+    out = transitions[index];
+    return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+
+// ===== UI State Machine =====
+// Screens are states of a table-driven machine. Each frame the caller builds a
+// small view model; the screen is only redrawn when that view model changes.
+
+#define UI_WELCOME_DURATION 3000   // milliseconds
+#define UI_MESSAGE_DURATION 2000   // Access granted/denied screens
+
+enum UiState : uint8_t
+{
+    UI_WELCOME = 0,
+    UI_PIN_ENTRY,
+    UI_GRANTED,
+    UI_DENIED,
+    UI_LOCKOUT,
+    UI_HOME,
+    UI_STATE_COUNT
+};
+
+enum UiEvent : uint8_t
+{
+    UI_EVENT_TIMEOUT = 0,   // Timed screen finished
+    UI_EVENT_PIN_OK,
+    UI_EVENT_PIN_BAD,
+    UI_EVENT_LOCKED,
+    UI_EVENT_UNLOCKED,
+    UI_EVENT_COUNT
+};
+
+struct UiTransition
+{
+    UiState from;
+    UiEvent event;
+    UiState to;
+};
+
+struct UiViewModel
+{
+    UiState state;
+    uint8_t pinPosition;
+    uint8_t attemptsLeft;       // 0 on the PIN screen = hint hidden
+    uint8_t percentage;
+    uint8_t fillLevel;
+    uint8_t charging;
+    uint8_t animFrame;
+    uint16_t countdownSeconds;
+};
+
+struct UiMachine
+{
+    UiState state;
+    uint32_t enteredAtMs;
+    UiViewModel rendered;
+    bool renderedValid;
+    uint32_t redraws;           // Screens drawn since uiBegin()
+};
+
+void uiBegin(UiMachine &ui, uint32_t nowMs);
+bool uiDispatch(UiMachine &ui, UiEvent event, uint32_t nowMs); // false if the event is ignored in this state
+UiState uiNextState(UiState state, UiEvent event);             // UI_STATE_COUNT if no transition
+bool uiTimedOut(const UiMachine &ui, uint32_t nowMs);
+bool uiShouldRender(UiMachine &ui, const UiViewModel &view);   // Records the view as rendered
+
+// The transition table as listed, for tests and diagnostics
+uint8_t uiTransitionCount();
+bool uiGetTransition(uint8_t index, UiTransition &out);
@@ -0,0 +1,57 @@
+#include "fake_adc.h"
+
+#include <math.h>
+
+#include "adc_block.h"
+
+uint16_t fakeAdcCode(float pinMv)
+{
+    float code = pinMv * ADC_RAW_MAX / FAKE_ADC_FULL_SCALE_MV + 0.5f;
+    if (code < 0)
+    {
+        return 0;
+    }
+    return code > ADC_RAW_MAX ? ADC_RAW_MAX : (uint16_t)code;
+}
+
+float fakeAdcMillivolts(uint32_t code)
+{
+    return code * FAKE_ADC_FULL_SCALE_MV / ADC_RAW_MAX;
+}
+
+static uint32_t nextRandom(FakeAdc &adc)
+{
+    adc.seed = adc.seed * 1664525u + 1013904223u;
+    return adc.seed >> 8;
+}
+
+void fakeAdcFill(FakeAdc &adc, uint8_t *out, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint8_t channel = adc.channel;
+        float pinMv = adc.pinMv;
+        if (adc.rippleMv > 0)
+        {
+            double t = (double)adc.sampleIndex / adc.sampleHz;
+            pinMv += adc.rippleMv * (float)sin(2.0 * M_PI * adc.rippleHz * t);
+        }
+        adc.sampleIndex++;
+        int32_t code = fakeAdcCode(pinMv);
+        if (adc.noiseCodes > 0)
+        {
+            code += (int32_t)(nextRandom(adc) % (2u * adc.noiseCodes + 1)) - adc.noiseCodes;
+        }
+        if (adc.foreignEvery > 0 && i % adc.foreignEvery == adc.foreignEvery - 1u)
+        {
+            // Stray result from another channel, pinned to full scale so it would show
+            channel = (uint8_t)((adc.channel + 1) & 0x0F);
+            code = ADC_RAW_MAX;
+        }
+        code = code < 0 ? 0 : code > ADC_RAW_MAX ? ADC_RAW_MAX : code;
+
+        uint16_t result = (uint16_t)((channel << 12) | code);
+        out[i * ADC_RESULT_BYTES] = (uint8_t)(result & 0xFF);
+        out[i * ADC_RESULT_BYTES + 1] = (uint8_t)(result >> 8);
+    }
+}
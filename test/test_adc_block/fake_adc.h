@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+// Host fake for the continuous ADC driver: fills DMA blocks with synthetic
+// TYPE1 results the way adc_digi_read_bytes() hands them to the sampler.
+
+#define FAKE_ADC_FULL_SCALE_MV 3100.0f  // Nominal 11 dB range, stands in for esp_adc_cal
+
+struct FakeAdc
+{
+    uint8_t channel;
+    float pinMv;
+    uint16_t noiseCodes;    // Peak noise added to every result (+/-)
+    uint8_t foreignEvery;   // Every Nth result comes from another channel (0 = never)
+    float rippleMv;         // Peak mains ripple on the pin (0 = none)
+    float rippleHz;
+    uint32_t sampleHz;      // Sample rate the ripple is timed against
+    uint32_t sampleIndex;   // Results written so far, continues across fills
+    uint32_t seed;
+};
+
+uint16_t fakeAdcCode(float pinMv);
+float fakeAdcMillivolts(uint32_t code);
+
+// Writes count results into out (count * ADC_RESULT_BYTES bytes)
+void fakeAdcFill(FakeAdc &adc, uint8_t *out, uint32_t count);
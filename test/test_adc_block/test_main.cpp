@@ -0,0 +1,173 @@
+#include <unity.h>
+
+#include "adc_sampler.h"
+#include "fake_adc.h"
+
+// Window averaging and pack calibration, fed with synthetic DMA blocks
+
+#define PACK_CHANNEL 0
+#define WINDOW_SAMPLES (ADC_SAMPLE_FREQ_HZ / 1000 * ADC_WINDOW_MS)
+
+static uint8_t block[ADC_BLOCK_SAMPLES * ADC_RESULT_BYTES];
+
+static FakeAdc packAdc(float packV)
+{
+    FakeAdc adc = {};
+    adc.channel = PACK_CHANNEL;
+    adc.pinMv = packV / ADC_DIVIDER_RATIO * 1000.0f;
+    adc.sampleHz = ADC_SAMPLE_FREQ_HZ;
+    adc.seed = 7;
+    return adc;
+}
+
+// What the sampler reports for a window, with the fake standing in for esp_adc_cal
+static float windowPackVoltage(const AdcWindow &window)
+{
+    uint32_t averageRaw = 0;
+    TEST_ASSERT_TRUE(adcWindowAverage(window, averageRaw));
+    return adcPinToPackVoltage(fakeAdcMillivolts(averageRaw));
+}
+
+// Fills blocks from the fake the way the sampler drains the DMA buffer
+static float sampledPackVoltage(FakeAdc &adc, uint32_t samples)
+{
+    AdcWindow window;
+    adcWindowReset(window);
+    for (uint32_t done = 0; done < samples; done += ADC_BLOCK_SAMPLES)
+    {
+        fakeAdcFill(adc, block, ADC_BLOCK_SAMPLES);
+        adcWindowAdd(window, block, sizeof(block), PACK_CHANNEL);
+    }
+    return windowPackVoltage(window);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_constant_block_averages_exactly(void)
+{
+    FakeAdc adc = packAdc(11.1f);
+    fakeAdcFill(adc, block, ADC_BLOCK_SAMPLES);
+
+    AdcWindow window;
+    adcWindowReset(window);
+    adcWindowAdd(window, block, sizeof(block), PACK_CHANNEL);
+    uint32_t averageRaw = 0;
+    TEST_ASSERT_TRUE(adcWindowAverage(window, averageRaw));
+    TEST_ASSERT_EQUAL_UINT32(ADC_BLOCK_SAMPLES, window.count);
+    TEST_ASSERT_EQUAL_UINT32(fakeAdcCode(adc.pinMv), averageRaw);
+}
+
+void test_average_rounds_to_nearest(void)
+{
+    // Codes 101, 100, 101: the first two average 100.5 and round up
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        uint16_t code = i % 2 == 0 ? 101 : 100;
+        block[i * 2] = (uint8_t)(code & 0xFF);
+        block[i * 2 + 1] = (uint8_t)(code >> 8);
+    }
+    AdcWindow window;
+    adcWindowReset(window);
+    adcWindowAdd(window, block, 4, PACK_CHANNEL);
+    uint32_t averageRaw = 0;
+    TEST_ASSERT_TRUE(adcWindowAverage(window, averageRaw));
+    TEST_ASSERT_EQUAL_UINT32(101, averageRaw);
+    adcWindowAdd(window, block + 4, 2, PACK_CHANNEL);
+    TEST_ASSERT_TRUE(adcWindowAverage(window, averageRaw));
+    TEST_ASSERT_EQUAL_UINT32(101, averageRaw);
+}
+
+void test_noise_averages_out(void)
+{
+    FakeAdc adc = packAdc(12.0f);
+    adc.noiseCodes = 40;
+    for (uint32_t round = 0; round < 20; round++)
+    {
+        TEST_ASSERT_FLOAT_WITHIN(0.02f, 12.0f, sampledPackVoltage(adc, WINDOW_SAMPLES));
+    }
+}
+
+void test_window_cancels_mains_ripple(void)
+{
+    // 0.5 V of ripple at the pack: a single block sees a slice of one period,
+    // the window spans whole periods of both 50 Hz and 60 Hz
+    const float mainsHz[] = {50.0f, 60.0f, 100.0f, 120.0f};
+    for (float hz : mainsHz)
+    {
+        FakeAdc adc = packAdc(12.0f);
+        adc.rippleMv = 0.5f / ADC_DIVIDER_RATIO * 1000.0f;
+        adc.rippleHz = hz;
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, 12.0f, sampledPackVoltage(adc, WINDOW_SAMPLES));
+    }
+
+    FakeAdc adc = packAdc(12.0f);
+    adc.rippleMv = 0.5f / ADC_DIVIDER_RATIO * 1000.0f;
+    adc.rippleHz = 50.0f;
+    float blockOnly = sampledPackVoltage(adc, ADC_BLOCK_SAMPLES);
+    TEST_ASSERT_TRUE(blockOnly - 12.0f > 0.2f);
+}
+
+void test_other_channels_and_partial_results_are_ignored(void)
+{
+    FakeAdc adc = packAdc(10.0f);
+    adc.foreignEvery = 4;
+    fakeAdcFill(adc, block, ADC_BLOCK_SAMPLES);
+
+    AdcWindow window;
+    adcWindowReset(window);
+    adcWindowAdd(window, block, sizeof(block), PACK_CHANNEL);
+    TEST_ASSERT_EQUAL_UINT32(ADC_BLOCK_SAMPLES - ADC_BLOCK_SAMPLES / 4, window.count);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 10.0f, windowPackVoltage(window));
+
+    // A trailing odd byte is not half a result
+    adcWindowReset(window);
+    adcWindowAdd(window, block, sizeof(block) - 1, PACK_CHANNEL);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 10.0f, windowPackVoltage(window));
+
+    uint32_t averageRaw = 12345;
+    adc.channel = 3;
+    adc.foreignEvery = 0;
+    fakeAdcFill(adc, block, ADC_BLOCK_SAMPLES);
+    adcWindowReset(window);
+    adcWindowAdd(window, block, sizeof(block), PACK_CHANNEL);
+    adcWindowAdd(window, block, 0, PACK_CHANNEL);
+    TEST_ASSERT_FALSE(adcWindowAverage(window, averageRaw));
+    TEST_ASSERT_EQUAL_UINT32(12345, averageRaw);
+}
+
+void test_pack_voltage_tracks_the_pack_across_its_range(void)
+{
+    // 3S pack from empty to full, plus the rails of the ADC range
+    const float packs[] = {0.0f, 9.0f, 11.1f, 12.6f, 17.0f};
+    for (float packV : packs)
+    {
+        FakeAdc adc = packAdc(packV);
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, packV, sampledPackVoltage(adc, WINDOW_SAMPLES));
+    }
+}
+
+void test_pack_voltage_is_the_divider(void)
+{
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, adcPinToPackVoltage(0.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, ADC_DIVIDER_RATIO, adcPinToPackVoltage(1000.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 3.1f * ADC_DIVIDER_RATIO, adcPinToPackVoltage(3100.0f));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_constant_block_averages_exactly);
+    RUN_TEST(test_average_rounds_to_nearest);
+    RUN_TEST(test_noise_averages_out);
+    RUN_TEST(test_window_cancels_mains_ripple);
+    RUN_TEST(test_other_channels_and_partial_results_are_ignored);
+    RUN_TEST(test_pack_voltage_tracks_the_pack_across_its_range);
+    RUN_TEST(test_pack_voltage_is_the_divider);
+    return UNITY_END();
+}
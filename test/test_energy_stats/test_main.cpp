@@ -0,0 +1,225 @@
+#include <unity.h>
+
+#include <math.h>
+#include <vector>
+
+#include "energy_stats.h"
+
+// Rollups are checked against a brute-force recomputation over the raw samples
+
+#define SAMPLE_INTERVAL_MS 1000
+#define SAMPLE_RUN_MS (26ULL * 3600000ULL)   // Closes one day and 25 hours
+#define GAP_EVERY 997                        // Every Nth sample arrives after a gap
+#define GAP_MS 8000                          // Longer than ENERGY_MAX_GAP_MS
+
+struct RawSample
+{
+    uint64_t timeMs;
+    float powerW;
+    float currentA;
+    bool charging;
+    double wh;        // Trapezoid since the previous sample (0 across gaps)
+    double ah;
+    uint32_t dtMs;
+};
+
+struct Expected
+{
+    uint32_t count;
+    double minW;
+    double maxW;
+    double meanW;
+    double variance;
+    double wh;
+    double ah;
+    uint32_t chargeMs;
+    uint32_t dischargeMs;
+};
+
+static std::vector<RawSample> samples;
+
+static uint32_t lcgState = 12345;
+
+static float noise()
+{
+    lcgState = lcgState * 1664525u + 1013904223u;
+    return (float)(lcgState >> 8) / 16777216.0f - 0.5f;
+}
+
+static void addSample(uint64_t timeMs)
+{
+    RawSample sample = {};
+    sample.timeMs = timeMs;
+    sample.powerW = 6.0f + 3.0f * sinf((float)timeMs / 90000.0f) + noise();
+    sample.currentA = sample.powerW / 12.0f;
+    sample.charging = (timeMs / 60000) % 17 < 5;
+
+    if (!samples.empty())
+    {
+        const RawSample &previous = samples.back();
+        uint64_t dtMs = timeMs - previous.timeMs;
+        if (dtMs <= ENERGY_MAX_GAP_MS)
+        {
+            double hours = (double)dtMs / 3600000.0;
+            sample.wh = ((double)sample.powerW + previous.powerW) * 0.5 * hours;
+            sample.ah = ((double)sample.currentA + previous.currentA) * 0.5 * hours;
+            sample.dtMs = (uint32_t)dtMs;
+        }
+    }
+
+    samples.push_back(sample);
+    energyStatsAddSample(sample.timeMs, sample.powerW, sample.currentA, sample.charging);
+}
+
+static Expected bruteForce(uint32_t startMinute, uint32_t minutes)
+{
+    Expected expected = {};
+    double sum = 0;
+    double sumSquares = 0;
+    for (const RawSample &sample : samples)
+    {
+        uint32_t minute = (uint32_t)(sample.timeMs / 60000);
+        if (minute < startMinute || minute >= startMinute + minutes)
+        {
+            continue;
+        }
+        if (expected.count == 0 || sample.powerW < expected.minW) expected.minW = sample.powerW;
+        if (expected.count == 0 || sample.powerW > expected.maxW) expected.maxW = sample.powerW;
+        expected.count++;
+        sum += sample.powerW;
+        sumSquares += (double)sample.powerW * sample.powerW;
+        expected.wh += sample.wh;
+        expected.ah += sample.ah;
+        if (sample.charging)
+        {
+            expected.chargeMs += sample.dtMs;
+        }
+        else
+        {
+            expected.dischargeMs += sample.dtMs;
+        }
+    }
+    if (expected.count > 0)
+    {
+        expected.meanW = sum / expected.count;
+        expected.variance = sumSquares / expected.count - expected.meanW * expected.meanW;
+    }
+    return expected;
+}
+
+static void assertClose(double expected, double actual, const char *what)
+{
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(fabs(expected) * 1e-3 + 1e-4, expected, actual, what);
+}
+
+static void assertMatches(const EnergyRollup &rollup, uint32_t minutes)
+{
+    Expected expected = bruteForce(rollup.startMinute, minutes);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.count, rollup.count, "count");
+    TEST_ASSERT_EQUAL_FLOAT(expected.minW, rollup.minW);
+    TEST_ASSERT_EQUAL_FLOAT(expected.maxW, rollup.maxW);
+    assertClose(expected.meanW, rollup.meanW, "mean");
+    assertClose(expected.variance, energyRollupVariance(rollup), "variance");
+    assertClose(expected.wh, rollup.wh, "Wh");
+    assertClose(expected.ah, rollup.ah, "Ah");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.chargeMs, rollup.chargeMs, "chargeMs");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.dischargeMs, rollup.dischargeMs, "dischargeMs");
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+static void runSamples()
+{
+    samples.clear();
+    lcgState = 12345;
+    energyStatsBegin(0);
+
+    uint64_t timeMs = 0;
+    for (uint32_t i = 0; timeMs < SAMPLE_RUN_MS; i++)
+    {
+        addSample(timeMs);
+        timeMs += (i % GAP_EVERY == GAP_EVERY - 1) ? GAP_MS : SAMPLE_INTERVAL_MS;
+    }
+}
+
+void test_minute_rollups_match_brute_force(void)
+{
+    TEST_ASSERT_EQUAL_UINT8(ENERGY_MINUTE_SLOTS, energyStatsCount(ENERGY_MINUTE));
+
+    EnergyRollup rollup;
+    for (uint8_t i = 0; i < ENERGY_MINUTE_SLOTS; i++)
+    {
+        TEST_ASSERT_TRUE(energyStatsGet(ENERGY_MINUTE, i, rollup));
+        assertMatches(rollup, 1);
+    }
+}
+
+void test_hour_rollups_match_brute_force(void)
+{
+    TEST_ASSERT_EQUAL_UINT8(25, energyStatsCount(ENERGY_HOUR));
+
+    EnergyRollup rollup;
+    for (uint8_t i = 0; i < energyStatsCount(ENERGY_HOUR); i++)
+    {
+        TEST_ASSERT_TRUE(energyStatsGet(ENERGY_HOUR, i, rollup));
+        TEST_ASSERT_EQUAL_UINT32(25 - i - 1, rollup.startMinute / 60);
+        assertMatches(rollup, 60);
+    }
+}
+
+void test_day_rollup_matches_brute_force(void)
+{
+    TEST_ASSERT_EQUAL_UINT8(1, energyStatsCount(ENERGY_DAY));
+
+    EnergyRollup rollup;
+    TEST_ASSERT_TRUE(energyStatsGet(ENERGY_DAY, 0, rollup));
+    TEST_ASSERT_EQUAL_UINT32(0, rollup.startMinute);
+    assertMatches(rollup, 1440);
+    TEST_ASSERT_FALSE(energyStatsGet(ENERGY_DAY, 1, rollup));
+}
+
+void test_current_periods_include_open_levels(void)
+{
+    const uint32_t levelMinutes[ENERGY_LEVEL_COUNT] = {1, 60, 1440};
+
+    EnergyRollup rollup;
+    for (uint8_t level = 0; level < ENERGY_LEVEL_COUNT; level++)
+    {
+        TEST_ASSERT_TRUE(energyStatsCurrent((EnergyLevel)level, rollup));
+        assertMatches(rollup, levelMinutes[level]);
+    }
+}
+
+void test_gaps_are_not_integrated(void)
+{
+    energyStatsBegin(0);
+    energyStatsAddSample(0, 10.0f, 1.0f, false);
+    energyStatsAddSample(1000, 10.0f, 1.0f, false);
+    energyStatsAddSample(1000 + ENERGY_MAX_GAP_MS + 1, 10.0f, 1.0f, true);
+
+    EnergyRollup rollup;
+    TEST_ASSERT_TRUE(energyStatsCurrent(ENERGY_MINUTE, rollup));
+    TEST_ASSERT_EQUAL_UINT32(3, rollup.count);
+    assertClose(10.0 / 3600.0, rollup.wh, "Wh");
+    TEST_ASSERT_EQUAL_UINT32(1000, rollup.dischargeMs);
+    TEST_ASSERT_EQUAL_UINT32(0, rollup.chargeMs);
+}
+
+int main()
+{
+    runSamples();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_minute_rollups_match_brute_force);
+    RUN_TEST(test_hour_rollups_match_brute_force);
+    RUN_TEST(test_day_rollup_matches_brute_force);
+    RUN_TEST(test_current_periods_include_open_levels);
+    RUN_TEST(test_gaps_are_not_integrated);
+    return UNITY_END();
+}
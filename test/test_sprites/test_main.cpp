@@ -0,0 +1,244 @@
+#include <unity.h>
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+#include "sprites.h"
+
+// Compares the atlas against the rect()/line() drawing it replaced, on a host
+// copy of the SSH1106 page buffer, and benchmarks the two paths
+
+#define SCREEN_W 128
+#define SCREEN_H 64
+#define BATTERY_X 5
+#define BATTERY_Y 8
+#define BENCH_FRAMES 20000
+
+struct Screen
+{
+    uint8_t buffer[SCREEN_W * SCREEN_H / 8];
+
+    void clear()
+    {
+        memset(buffer, 0, sizeof(buffer));
+    }
+
+    void dot(int x, int y, bool on)
+    {
+        if (x < 0 || x >= SCREEN_W || y < 0 || y >= SCREEN_H)
+        {
+            return;
+        }
+        uint8_t mask = (uint8_t)(1 << (y % 8));
+        uint8_t &b = buffer[(y / 8) * SCREEN_W + x];
+        b = on ? (uint8_t)(b | mask) : (uint8_t)(b & ~mask);
+    }
+
+    // Same shapes as GyverOLED rect() with OLED_FILL / OLED_STROKE
+    void rect(int x0, int y0, int x1, int y1, bool fill)
+    {
+        if (!fill)
+        {
+            line(x0, y0, x1, y0, true);
+            line(x0, y1, x1, y1, true);
+            line(x0, y0, x0, y1, true);
+            line(x1, y0, x1, y1, true);
+            return;
+        }
+        for (int x = x0; x <= x1; x++)
+        {
+            for (int y = y0; y <= y1; y++)
+            {
+                dot(x, y, true);
+            }
+        }
+    }
+
+    void line(int x0, int y0, int x1, int y1, bool on)
+    {
+        int dx = x1 > x0 ? x1 - x0 : x0 - x1;
+        int dy = y1 > y0 ? y0 - y1 : y1 - y0;
+        int sx = x0 < x1 ? 1 : -1;
+        int sy = y0 < y1 ? 1 : -1;
+        int err = dx + dy;
+        while (true)
+        {
+            dot(x0, y0, on);
+            if (x0 == x1 && y0 == y1)
+            {
+                break;
+            }
+            int e2 = 2 * err;
+            if (e2 >= dy)
+            {
+                err += dy;
+                x0 += sx;
+            }
+            if (e2 <= dx)
+            {
+                err += dx;
+                y0 += sy;
+            }
+        }
+    }
+
+    // drawBitmap(..., BUF_REPLACE) at a page-aligned y: one copy per page row
+    void blit(int x, int y, const uint8_t *sprite, int w, int h)
+    {
+        for (int page = 0; page < h / 8; page++)
+        {
+            memcpy(&buffer[(y / 8 + page) * SCREEN_W + x], &sprite[page * w], w);
+        }
+    }
+};
+
+static Screen legacy;
+static Screen atlas;
+
+// The border, drawBatteryIcon() and drawChargingAnimation() before the atlas
+static void drawLegacy(Screen &screen, int chargingFrame, int fillWidth)
+{
+    const int bx = BATTERY_X;
+    const int by = BATTERY_Y;
+
+    screen.rect(0, 0, 127, 63, false);
+    screen.rect(bx, by, bx + 32, by + 12, false);
+    screen.rect(bx + 32, by + 4, bx + 35, by + 8, true);
+    if (fillWidth > 0)
+    {
+        screen.rect(bx + 1, by + 1, bx + 1 + fillWidth, by + 11, true);
+    }
+
+    switch (chargingFrame)
+    {
+        case 0:
+            screen.line(bx + 15, by + 3, bx + 18, by + 6, true);
+            screen.line(bx + 18, by + 6, bx + 14, by + 6, true);
+            screen.line(bx + 14, by + 6, bx + 17, by + 9, true);
+            break;
+        case 1:
+            for (int i = 0; i < 30; i += 6)
+            {
+                if (i < fillWidth)
+                {
+                    screen.line(bx + 1 + i, by + 1, bx + 1 + i + 2, by + 1, false);
+                }
+            }
+            break;
+        case 2:
+            screen.line(bx + 16, by + 3, bx + 19, by + 6, true);
+            screen.line(bx + 19, by + 6, bx + 15, by + 6, true);
+            screen.line(bx + 15, by + 6, bx + 18, by + 9, true);
+            break;
+        case 3:
+            if (fillWidth < 30)
+            {
+                int extraWidth = 30 - fillWidth < 5 ? 30 - fillWidth : 5;
+                screen.rect(bx + 1 + fillWidth, by + 1, bx + 1 + fillWidth + extraWidth, by + 11, true);
+            }
+            break;
+    }
+}
+
+// drawBorder() and drawBatteryIcon() with the atlas
+static void drawAtlasBorder(Screen &screen)
+{
+    screen.blit(0, 0, borderSprite(BORDER_TOP), BORDER_W, BORDER_EDGE_H);
+    screen.blit(0, BORDER_EDGE_H, borderSprite(BORDER_SIDE), 1, BORDER_SIDE_H);
+    screen.blit(BORDER_W - 1, BORDER_EDGE_H, borderSprite(BORDER_SIDE), 1, BORDER_SIDE_H);
+    screen.blit(0, BORDER_H - BORDER_EDGE_H, borderSprite(BORDER_BOTTOM), BORDER_W, BORDER_EDGE_H);
+}
+
+static void drawAtlas(Screen &screen, uint8_t frame, uint8_t fillLevel)
+{
+    drawAtlasBorder(screen);
+    screen.blit(BATTERY_X, BATTERY_Y, batterySprite(frame, fillLevel), BATTERY_SPRITE_W, BATTERY_SPRITE_H);
+}
+
+void setUp(void)
+{
+    legacy.clear();
+    atlas.clear();
+}
+
+void tearDown(void)
+{
+}
+
+void test_border_matches_rect(void)
+{
+    legacy.rect(0, 0, 127, 63, false);
+    drawAtlasBorder(atlas);
+    TEST_ASSERT_EQUAL_MEMORY(legacy.buffer, atlas.buffer, sizeof(legacy.buffer));
+}
+
+void test_every_frame_and_level_matches_legacy_drawing(void)
+{
+    char message[48];
+    for (uint8_t frame = 0; frame < BATTERY_FRAMES; frame++)
+    {
+        for (uint8_t level = 0; level < BATTERY_FILL_LEVELS; level++)
+        {
+            legacy.clear();
+            atlas.clear();
+            drawLegacy(legacy, (int)frame - 1, level);
+            drawAtlas(atlas, frame, level);
+            snprintf(message, sizeof(message), "frame %u level %u", frame, level);
+            TEST_ASSERT_EQUAL_MEMORY_MESSAGE(legacy.buffer, atlas.buffer, sizeof(legacy.buffer), message);
+        }
+    }
+}
+
+void test_out_of_range_requests_are_clamped(void)
+{
+    TEST_ASSERT_TRUE(batterySprite(BATTERY_FRAMES, 0) == batterySprite(BATTERY_FRAME_STATIC, 0));
+    TEST_ASSERT_TRUE(batterySprite(0, 255) == batterySprite(0, BATTERY_FILL_LEVELS - 1));
+}
+
+static double nsPerFrame(bool useAtlas)
+{
+    volatile uint8_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_FRAMES; i++)
+    {
+        uint8_t frame = (uint8_t)(i % BATTERY_FRAMES);
+        uint8_t level = (uint8_t)(i % BATTERY_FILL_LEVELS);
+        Screen &screen = useAtlas ? atlas : legacy;
+        screen.clear();
+        if (useAtlas)
+        {
+            drawAtlas(screen, frame, level);
+        }
+        else
+        {
+            drawLegacy(screen, (int)frame - 1, level);
+        }
+        sink = sink + screen.buffer[SCREEN_W + BATTERY_X + level];
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    (void)sink;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / BENCH_FRAMES;
+}
+
+void test_benchmark_atlas_against_legacy(void)
+{
+    double legacyNs = nsPerFrame(false);
+    double atlasNs = nsPerFrame(true);
+
+    char message[96];
+    snprintf(message, sizeof(message), "border + battery icon: legacy %.0f ns/frame, atlas %.0f ns/frame (%.1fx)",
+             legacyNs, atlasNs, legacyNs / atlasNs);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(atlasNs < legacyNs);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_border_matches_rect);
+    RUN_TEST(test_every_frame_and_level_matches_legacy_drawing);
+    RUN_TEST(test_out_of_range_requests_are_clamped);
+    RUN_TEST(test_benchmark_atlas_against_legacy);
+    return UNITY_END();
+}
@@ -0,0 +1,192 @@
+#include <unity.h>
+
+#include <math.h>
+#include <string.h>
+
+#include "telemetry_codec.h"
+
+// Lossless round trips through the block codec, including values and
+// timestamps that hit every encoding branch
+
+#define BLOCK_BYTES 252
+#define TRACE_SAMPLES 4000
+
+static uint8_t block[BLOCK_BYTES];
+static TelemetrySample trace[TRACE_SAMPLES];
+
+static uint32_t lcgState = 1;
+
+static uint32_t nextRandom()
+{
+    lcgState = lcgState * 1664525u + 1013904223u;
+    return lcgState;
+}
+
+static float bitsToFloat(uint32_t bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static bool sameSample(const TelemetrySample &a, const TelemetrySample &b)
+{
+    return a.timeMs == b.timeMs &&
+           memcmp(&a.voltage, &b.voltage, sizeof(float)) == 0 &&
+           memcmp(&a.current, &b.current, sizeof(float)) == 0 &&
+           memcmp(&a.power, &b.power, sizeof(float)) == 0;
+}
+
+// Encodes the whole trace block by block and checks every decoded sample
+static uint32_t roundTrip(const TelemetrySample *samples, uint32_t count)
+{
+    uint32_t blocks = 0;
+    uint32_t next = 0;
+    while (next < count)
+    {
+        uint32_t first = next;
+        TelemetryEncoder encoder;
+        telemetryEncoderBegin(encoder, block, sizeof(block));
+        while (next < count && telemetryEncoderAdd(encoder, samples[next]))
+        {
+            next++;
+        }
+        TEST_ASSERT_TRUE_MESSAGE(next > first, "a fresh block must take at least one sample");
+        uint16_t length = telemetryEncoderFinish(encoder);
+        TEST_ASSERT_LESS_OR_EQUAL(BLOCK_BYTES, length);
+        blocks++;
+
+        TelemetryDecoder decoder;
+        TelemetrySample decoded;
+        TEST_ASSERT_TRUE(telemetryDecoderBegin(decoder, block, length));
+        for (uint32_t i = first; i < next; i++)
+        {
+            TEST_ASSERT_TRUE(telemetryDecoderNext(decoder, decoded));
+            TEST_ASSERT_TRUE_MESSAGE(sameSample(samples[i], decoded), "decoded sample differs");
+        }
+        TEST_ASSERT_FALSE(telemetryDecoderNext(decoder, decoded));
+    }
+    return blocks;
+}
+
+void setUp(void)
+{
+    lcgState = 1;
+}
+
+void tearDown(void)
+{
+}
+
+void test_bench_trace_round_trips_and_compresses(void)
+{
+    uint32_t timeMs = 1000;
+    float voltage = 12.4f;
+    for (uint32_t i = 0; i < TRACE_SAMPLES; i++)
+    {
+        timeMs += 500 + (nextRandom() % 10 == 0 ? nextRandom() % 40 : 0);
+        voltage -= 0.0001f;
+        trace[i].timeMs = timeMs;
+        trace[i].voltage = roundf(voltage * 1000.0f) / 1000.0f;
+        trace[i].current = roundf((1.2f + (int)(nextRandom() % 5) * 0.001f) * 1000.0f) / 1000.0f;
+        trace[i].power = roundf(trace[i].voltage * trace[i].current * 1000.0f) / 1000.0f;
+    }
+
+    uint32_t blocks = roundTrip(trace, TRACE_SAMPLES);
+
+    // Raw samples are 16 bytes; slowly changing readings must pack well below that
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(TRACE_SAMPLES * 16 / 2, blocks * BLOCK_BYTES);
+}
+
+void test_special_values_round_trip(void)
+{
+    const float values[] = {0.0f, -0.0f, INFINITY, -INFINITY, NAN, 1e-45f, -3.4e38f, 3.4e38f, 12.0f, 12.0f};
+    const uint32_t count = sizeof(values) / sizeof(values[0]);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        trace[i].timeMs = 100 + i;
+        trace[i].voltage = values[i];
+        trace[i].current = values[count - 1 - i];
+        trace[i].power = values[(i * 3) % count];
+    }
+    roundTrip(trace, count);
+}
+
+void test_timestamp_jumps_round_trip(void)
+{
+    // Repeats, backwards steps, large gaps and 32-bit wrap
+    const uint32_t times[] = {0, 0, 500, 1000, 900, 1000000, 1000001, 0xFFFFFFF0u, 5, 6, 4000000000u, 7};
+    const uint32_t count = sizeof(times) / sizeof(times[0]);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        trace[i].timeMs = times[i];
+        trace[i].voltage = 11.7f;
+        trace[i].current = 0.5f;
+        trace[i].power = 5.85f;
+    }
+    roundTrip(trace, count);
+}
+
+void test_worst_case_samples_never_tear_a_block(void)
+{
+    // Random bit patterns defeat the XOR windows and the timestamp buckets
+    for (uint32_t i = 0; i < TRACE_SAMPLES; i++)
+    {
+        trace[i].timeMs = nextRandom();
+        trace[i].voltage = bitsToFloat(nextRandom());
+        trace[i].current = bitsToFloat(nextRandom());
+        trace[i].power = bitsToFloat(nextRandom());
+    }
+    roundTrip(trace, TRACE_SAMPLES);
+}
+
+void test_truncated_block_stops_decoding(void)
+{
+    TelemetryEncoder encoder;
+    telemetryEncoderBegin(encoder, block, sizeof(block));
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        TelemetrySample sample = {1000 + i * 500, bitsToFloat(nextRandom()), 0.5f, 6.0f};
+        TEST_ASSERT_TRUE(telemetryEncoderAdd(encoder, sample));
+    }
+    uint16_t length = telemetryEncoderFinish(encoder);
+
+    TelemetryDecoder decoder;
+    TelemetrySample decoded;
+    TEST_ASSERT_FALSE(telemetryDecoderBegin(decoder, block, 1));
+    TEST_ASSERT_TRUE(telemetryDecoderBegin(decoder, block, length / 2));
+    uint32_t count = 0;
+    while (telemetryDecoderNext(decoder, decoded))
+    {
+        count++;
+    }
+    TEST_ASSERT_TRUE(count < 10);
+}
+
+void test_malformed_window_stops_decoding(void)
+{
+    // Two samples: a raw first sample, then dod 0 and a new XOR window with
+    // leading 31 and length 32, which does not fit in a 32-bit value
+    memset(block, 0, sizeof(block));
+    block[0] = 2;
+    block[2 + 16] = 0x7F; // 0 (dod), 1 (changed), 1 (new window), 11111 (leading)
+    block[2 + 17] = 0xF8; // 11111 (length - 1)
+
+    TelemetryDecoder decoder;
+    TelemetrySample decoded;
+    TEST_ASSERT_TRUE(telemetryDecoderBegin(decoder, block, 32));
+    TEST_ASSERT_TRUE(telemetryDecoderNext(decoder, decoded));
+    TEST_ASSERT_FALSE(telemetryDecoderNext(decoder, decoded));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_trace_round_trips_and_compresses);
+    RUN_TEST(test_special_values_round_trip);
+    RUN_TEST(test_timestamp_jumps_round_trip);
+    RUN_TEST(test_worst_case_samples_never_tear_a_block);
+    RUN_TEST(test_truncated_block_stops_decoding);
+    RUN_TEST(test_malformed_window_stops_decoding);
+    return UNITY_END();
+}
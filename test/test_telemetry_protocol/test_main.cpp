@@ -0,0 +1,148 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "telemetry_protocol.h"
+
+// CRC, COBS and framing of the binary telemetry stream
+
+static uint8_t frame[TELEMETRY_MAX_FRAME];
+static uint8_t scratch[TELEMETRY_MAX_FRAME];
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_crc_matches_ccitt_false_check_value(void)
+{
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    TEST_ASSERT_EQUAL_UINT16(0x29B1, telemetryCrc16(check, sizeof(check)));
+}
+
+void test_cobs_round_trips_zero_runs_and_long_blocks(void)
+{
+    static uint8_t input[600];
+    static uint8_t encoded[620];
+    static uint8_t decoded[620];
+
+    // Lengths around the 254-byte block limit, with and without zeros
+    const size_t lengths[] = {1, 2, 253, 254, 255, 508, 600};
+    for (uint8_t pattern = 0; pattern < 3; pattern++)
+    {
+        for (size_t length : lengths)
+        {
+            for (size_t i = 0; i < length; i++)
+            {
+                input[i] = pattern == 0 ? 0 : pattern == 1 ? (uint8_t)(i % 255 + 1) : (uint8_t)(i % 7);
+            }
+            size_t encodedLength = cobsEncode(input, length, encoded);
+            TEST_ASSERT_TRUE(memchr(encoded, 0, encodedLength) == NULL);
+            TEST_ASSERT_LESS_OR_EQUAL(length + length / 254 + 1, encodedLength);
+            TEST_ASSERT_EQUAL(length, cobsDecode(encoded, encodedLength, decoded));
+            TEST_ASSERT_EQUAL_MEMORY(input, decoded, length);
+        }
+    }
+}
+
+void test_cobs_rejects_malformed_input(void)
+{
+    const uint8_t overrun[] = {0x05, 0x11, 0x22};
+    const uint8_t embeddedZero[] = {0x03, 0x11, 0x00};
+    uint8_t out[8];
+    TEST_ASSERT_EQUAL(0, cobsDecode(overrun, sizeof(overrun), out));
+    TEST_ASSERT_EQUAL(0, cobsDecode(embeddedZero, sizeof(embeddedZero), out));
+}
+
+void test_sample_frame_round_trips(void)
+{
+    TelemetrySample sample = {123456, 11.85f, -0.75f, -8.8875f};
+    uint8_t payload[TELEMETRY_SAMPLE_PAYLOAD];
+    TEST_ASSERT_EQUAL(TELEMETRY_SAMPLE_PAYLOAD, telemetryPackSample(sample, TELEMETRY_FLAG_CHARGING, payload));
+
+    size_t length = telemetryBuildFrame(TELEMETRY_PACKET_SAMPLE, 0xBEEF, payload, sizeof(payload), frame);
+    TEST_ASSERT_EQUAL_UINT8(0x00, frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(0x00, frame[length - 1]);
+    TEST_ASSERT_TRUE(memchr(frame + 1, 0, length - 2) == NULL);
+
+    TelemetryPacket packet;
+    TEST_ASSERT_TRUE(telemetryParseFrame(frame + 1, length - 2, scratch, packet));
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_PACKET_SAMPLE, packet.type);
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, packet.seq);
+
+    TelemetrySample decoded;
+    uint8_t flags;
+    TEST_ASSERT_TRUE(telemetryUnpackSample(packet, decoded, flags));
+    TEST_ASSERT_EQUAL_UINT32(sample.timeMs, decoded.timeMs);
+    TEST_ASSERT_EQUAL_FLOAT(sample.voltage, decoded.voltage);
+    TEST_ASSERT_EQUAL_FLOAT(sample.current, decoded.current);
+    TEST_ASSERT_EQUAL_FLOAT(sample.power, decoded.power);
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_FLAG_CHARGING, flags);
+
+    TelemetryEvent event;
+    TEST_ASSERT_FALSE(telemetryUnpackEvent(packet, event));
+}
+
+void test_event_frame_round_trips(void)
+{
+    TelemetryEvent event = {42, TELEMETRY_EVENT_LOCKOUT, 300000};
+    uint8_t payload[TELEMETRY_EVENT_PAYLOAD];
+    TEST_ASSERT_EQUAL(TELEMETRY_EVENT_PAYLOAD, telemetryPackEvent(event, payload));
+
+    size_t length = telemetryBuildFrame(TELEMETRY_PACKET_EVENT, 7, payload, sizeof(payload), frame);
+    TelemetryPacket packet;
+    TEST_ASSERT_TRUE(telemetryParseFrame(frame + 1, length - 2, scratch, packet));
+
+    TelemetryEvent decoded;
+    TEST_ASSERT_TRUE(telemetryUnpackEvent(packet, decoded));
+    TEST_ASSERT_EQUAL_UINT32(event.timeMs, decoded.timeMs);
+    TEST_ASSERT_EQUAL_UINT8(event.code, decoded.code);
+    TEST_ASSERT_EQUAL_INT32(event.value, decoded.value);
+}
+
+void test_corrupted_frames_are_rejected(void)
+{
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+    for (size_t i = 0; i < sizeof(payload); i++)
+    {
+        payload[i] = (uint8_t)(i * 37);
+    }
+    size_t length = telemetryBuildFrame(TELEMETRY_PACKET_BLOCK, 1, payload, sizeof(payload), frame);
+    TEST_ASSERT_LESS_OR_EQUAL(TELEMETRY_MAX_FRAME, length);
+
+    TelemetryPacket packet;
+    TEST_ASSERT_TRUE(telemetryParseFrame(frame + 1, length - 2, scratch, packet));
+    TEST_ASSERT_EQUAL_UINT16(TELEMETRY_MAX_PAYLOAD, packet.length);
+
+    // Every single bit flip must fail the COBS or CRC check
+    for (size_t byte = 1; byte < length - 1; byte++)
+    {
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            frame[byte] ^= (uint8_t)(1 << bit);
+            TEST_ASSERT_FALSE(telemetryParseFrame(frame + 1, length - 2, scratch, packet));
+            frame[byte] ^= (uint8_t)(1 << bit);
+        }
+    }
+
+    // Debug text between two delimiters is not a frame
+    const char text[] = "PIN correct - access granted\r\n";
+    TEST_ASSERT_FALSE(telemetryParseFrame((const uint8_t *)text, sizeof(text) - 1, scratch, packet));
+
+    TEST_ASSERT_EQUAL(0, telemetryBuildFrame(TELEMETRY_PACKET_BLOCK, 1, payload, TELEMETRY_MAX_PAYLOAD + 1, frame));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_crc_matches_ccitt_false_check_value);
+    RUN_TEST(test_cobs_round_trips_zero_runs_and_long_blocks);
+    RUN_TEST(test_cobs_rejects_malformed_input);
+    RUN_TEST(test_sample_frame_round_trips);
+    RUN_TEST(test_event_frame_round_trips);
+    RUN_TEST(test_corrupted_frames_are_rejected);
+    return UNITY_END();
+}
@@ -0,0 +1,184 @@
+#include <unity.h>
+
+#include "ui_state.h"
+
+// Transitions, timeouts and redraw rates of the screen state machine
+
+#define LOOP_PERIOD_MS 50           // delay(50) in loop()
+#define CHARGING_ANIM_SPEED 300     // As in main.cpp
+#define SIMULATED_SECONDS 60
+
+static UiMachine ui;
+
+static bool isListed(uint8_t state, uint8_t event)
+{
+    UiTransition transition;
+    for (uint8_t i = 0; uiGetTransition(i, transition); i++)
+    {
+        if (transition.from == state && transition.event == event)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Builds the home screen view the way buildViewModel() does
+static void homeView(UiViewModel &view, uint8_t percentage, bool charging, uint8_t animFrame)
+{
+    view = UiViewModel{};
+    view.state = UI_HOME;
+    view.percentage = percentage;
+    view.fillLevel = (uint8_t)(percentage * 30 / 100);
+    view.charging = charging ? 1 : 0;
+    view.animFrame = charging ? animFrame : 0;
+}
+
+void setUp(void)
+{
+    uiBegin(ui, 0);
+}
+
+void tearDown(void)
+{
+}
+
+void test_every_transition_dispatches(void)
+{
+    UiTransition transition;
+    TEST_ASSERT_EQUAL_UINT8(8, uiTransitionCount());
+    for (uint8_t i = 0; uiGetTransition(i, transition); i++)
+    {
+        ui.state = transition.from;
+        ui.enteredAtMs = 0;
+        TEST_ASSERT_TRUE(uiDispatch(ui, transition.event, 1234));
+        TEST_ASSERT_EQUAL_UINT8(transition.to, ui.state);
+        TEST_ASSERT_EQUAL_UINT32(1234, ui.enteredAtMs);
+        TEST_ASSERT_EQUAL_UINT8(transition.to, uiNextState(transition.from, transition.event));
+    }
+    TEST_ASSERT_FALSE(uiGetTransition(uiTransitionCount(), transition));
+}
+
+void test_unlisted_events_are_ignored(void)
+{
+    for (uint8_t state = 0; state < UI_STATE_COUNT; state++)
+    {
+        for (uint8_t event = 0; event < UI_EVENT_COUNT; event++)
+        {
+            if (isListed(state, event))
+            {
+                continue;
+            }
+            ui.state = (UiState)state;
+            ui.enteredAtMs = 10;
+            TEST_ASSERT_FALSE(uiDispatch(ui, (UiEvent)event, 99));
+            TEST_ASSERT_EQUAL_UINT8(state, ui.state);
+            TEST_ASSERT_EQUAL_UINT32(10, ui.enteredAtMs);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT8(UI_STATE_COUNT, uiNextState(UI_STATE_COUNT, UI_EVENT_TIMEOUT));
+    TEST_ASSERT_EQUAL_UINT8(UI_STATE_COUNT, uiNextState(UI_HOME, UI_EVENT_COUNT));
+}
+
+void test_timed_states_time_out(void)
+{
+    TEST_ASSERT_FALSE(uiTimedOut(ui, UI_WELCOME_DURATION - 1));
+    TEST_ASSERT_TRUE(uiTimedOut(ui, UI_WELCOME_DURATION));
+
+    const UiState messages[] = {UI_GRANTED, UI_DENIED};
+    for (UiState state : messages)
+    {
+        ui.state = state;
+        ui.enteredAtMs = 5000;
+        TEST_ASSERT_FALSE(uiTimedOut(ui, 5000 + UI_MESSAGE_DURATION - 1));
+        TEST_ASSERT_TRUE(uiTimedOut(ui, 5000 + UI_MESSAGE_DURATION));
+    }
+
+    const UiState untimed[] = {UI_PIN_ENTRY, UI_LOCKOUT, UI_HOME};
+    for (UiState state : untimed)
+    {
+        ui.state = state;
+        ui.enteredAtMs = 0;
+        TEST_ASSERT_FALSE(uiTimedOut(ui, 0xFFFFFFF0u));
+    }
+}
+
+void test_login_flow_reaches_home(void)
+{
+    TEST_ASSERT_TRUE(uiDispatch(ui, UI_EVENT_TIMEOUT, 3000));
+    TEST_ASSERT_TRUE(uiDispatch(ui, UI_EVENT_PIN_BAD, 4000));
+    TEST_ASSERT_TRUE(uiDispatch(ui, UI_EVENT_TIMEOUT, 6000));
+    TEST_ASSERT_TRUE(uiDispatch(ui, UI_EVENT_PIN_OK, 7000));
+    TEST_ASSERT_TRUE(uiDispatch(ui, UI_EVENT_TIMEOUT, 9000));
+    TEST_ASSERT_EQUAL_UINT8(UI_HOME, ui.state);
+}
+
+void test_lockout_redraws_once_per_second(void)
+{
+    ui.state = UI_LOCKOUT;
+    const uint32_t lockoutEndMs = 300000;
+    for (uint32_t now = 0; now < SIMULATED_SECONDS * 1000; now += LOOP_PERIOD_MS)
+    {
+        UiViewModel view = {};
+        view.state = UI_LOCKOUT;
+        view.countdownSeconds = (uint16_t)((lockoutEndMs - now) / 1000);
+        uiShouldRender(ui, view);
+    }
+    // First frame, then one per countdown second
+    TEST_ASSERT_EQUAL_UINT32(1 + SIMULATED_SECONDS, ui.redraws);
+}
+
+void test_idle_home_screen_draws_once(void)
+{
+    ui.state = UI_HOME;
+    UiViewModel view;
+    for (uint32_t now = 0; now < SIMULATED_SECONDS * 1000; now += LOOP_PERIOD_MS)
+    {
+        homeView(view, 76, false, 0);
+        uiShouldRender(ui, view);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, ui.redraws);
+
+    // A new percentage is drawn exactly once
+    homeView(view, 75, false, 0);
+    TEST_ASSERT_TRUE(uiShouldRender(ui, view));
+    TEST_ASSERT_FALSE(uiShouldRender(ui, view));
+    TEST_ASSERT_EQUAL_UINT32(2, ui.redraws);
+}
+
+void test_charging_home_screen_redraws_at_animation_rate(void)
+{
+    ui.state = UI_HOME;
+    uint8_t animFrame = 0;
+    uint32_t lastAnimUpdate = 0;
+    for (uint32_t now = 0; now < SIMULATED_SECONDS * 1000; now += LOOP_PERIOD_MS)
+    {
+        // advanceChargingAnimation()
+        if (now - lastAnimUpdate > CHARGING_ANIM_SPEED)
+        {
+            animFrame = (animFrame + 1) % 4;
+            lastAnimUpdate = now;
+        }
+        UiViewModel view;
+        homeView(view, 40, true, animFrame);
+        uiShouldRender(ui, view);
+    }
+
+    // One redraw per animation step (every 350 ms at a 50 ms loop), not per loop
+    uint32_t perSecondX10 = ui.redraws * 10 / SIMULATED_SECONDS;
+    TEST_ASSERT_EQUAL_UINT32(28, perSecondX10);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(SIMULATED_SECONDS * 1000 / CHARGING_ANIM_SPEED, ui.redraws);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_every_transition_dispatches);
+    RUN_TEST(test_unlisted_events_are_ignored);
+    RUN_TEST(test_timed_states_time_out);
+    RUN_TEST(test_login_flow_reaches_home);
+    RUN_TEST(test_lockout_redraws_once_per_second);
+    RUN_TEST(test_idle_home_screen_draws_once);
+    RUN_TEST(test_charging_home_screen_redraws_at_animation_rate);
+    return UNITY_END();
+}
@@ -0,0 +1,181 @@
+"""Per-module RAM/flash report from a GNU ld map file, checked against budgets.
+
+PlatformIO:  extra_scripts = post:tools/memory_report.py   (runs after linking)
+Standalone:  python3 tools/memory_report.py firmware.map [--budget tools/memory_budget.json]
+
+Sizes are summed per input object: sources under src/ are reported by file
+name (main, energy_stats, ...) and archive members by library (GyverOLED,
+FrameworkArduino, ...). Columns:
+  ram    data and bss in DRAM
+  iram   code and data placed in instruction RAM (.iram*)
+  rtc    RTC memory (.rtc*)
+  flash  code, read-only data and the initialisers of data, iram and rtc
+The build fails when a module or the total exceeds a limit in its budget; a
+column without a limit is only reported. The native environment is checked
+against tools/memory_budget_native.json, since host object sizes differ.
+"""
+
+import json
+import os
+import re
+import sys
+
+INPUT_SECTION = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+SECTION_ONLY = re.compile(r"^ (\S+)$")
+WRAPPED_REST = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+ARCHIVE_MEMBER = re.compile(r"^(.*)\((.*)\)$")
+
+CODE_PREFIXES = (".text", ".literal", ".rodata", ".srodata", ".flash", ".irom")
+DATA_PREFIXES = (".data", ".sdata", ".dram")
+COLUMNS = ("ram", "iram", "rtc", "flash")
+
+
+def classify(section):
+    """Returns the columns an input section counts towards."""
+    if section.startswith(".rtc"):
+        return ("rtc",) if ".bss" in section or "noinit" in section else ("rtc", "flash")
+    if section.startswith(".iram"):
+        return ("iram",) if ".bss" in section else ("iram", "flash")
+    if section == "COMMON" or ".bss" in section or "noinit" in section:
+        return ("ram",)
+    if section.startswith(DATA_PREFIXES):
+        return ("ram", "flash")
+    if section.startswith(CODE_PREFIXES):
+        return ("flash",)
+    return ()
+
+
+def module_name(path):
+    member = ARCHIVE_MEMBER.match(path)
+    if member:
+        library = os.path.basename(member.group(1))
+        if library.startswith("lib"):
+            library = library[3:]
+        return library.split(".")[0]
+    return os.path.basename(path).split(".")[0]
+
+
+def parse_map(path):
+    modules = {}
+    in_memory_map = False
+    pending_section = None
+
+    with open(path, "r", errors="replace") as map_file:
+        for line in map_file:
+            line = line.rstrip("\n")
+            if not in_memory_map:
+                in_memory_map = line.startswith("Linker script and memory map")
+                continue
+
+            if pending_section:
+                wrapped = WRAPPED_REST.match(line)
+                section, pending_section = pending_section, None
+                if wrapped:
+                    _, size, obj = wrapped.groups()
+                    add_section(modules, section, int(size, 16), obj)
+                    continue
+
+            match = INPUT_SECTION.match(line)
+            if match:
+                section, _, size, obj = match.groups()
+                add_section(modules, section, int(size, 16), obj)
+                continue
+
+            only = SECTION_ONLY.match(line)
+            if only:
+                pending_section = only.group(1)
+
+    return modules
+
+
+def add_section(modules, section, size, obj):
+    if size == 0 or obj.startswith("load address"):
+        return
+    columns = classify(section)
+    if not columns:
+        return
+    usage = modules.setdefault(module_name(obj.strip()), dict.fromkeys(COLUMNS, 0))
+    for column in columns:
+        usage[column] += size
+
+
+def load_budget(path):
+    if not path or not os.path.exists(path):
+        return {"modules": {}, "total": {}}
+    with open(path) as budget_file:
+        return json.load(budget_file)
+
+
+def write_row(out, name, usage, limit):
+    cells = ["%10d %8s" % (usage[kind], limit.get(kind, "-")) for kind in COLUMNS]
+    out.write("%-24s %s\n" % (name, " ".join(cells)))
+
+
+def over_limit(name, usage, limit):
+    return ["%s %s: %d > %d" % (name, kind, usage[kind], limit[kind])
+            for kind in COLUMNS if kind in limit and usage[kind] > limit[kind]]
+
+
+def check(modules, budget, out=sys.stdout):
+    total = {kind: sum(m[kind] for m in modules.values()) for kind in COLUMNS}
+    limits = budget.get("modules", {})
+    failures = []
+
+    out.write("%-24s %s\n" % ("module", " ".join("%10s %8s" % (kind, "max") for kind in COLUMNS)))
+    ranked = sorted(modules.items(), key=lambda item: sum(item[1].values()), reverse=True)
+    shown = [name for name, _ in ranked[:15]]
+    shown += [name for name in sorted(limits) if name not in shown]
+
+    for name in shown:
+        usage = modules.get(name, dict.fromkeys(COLUMNS, 0))
+        limit = limits.get(name, {})
+        write_row(out, name, usage, limit)
+        failures += over_limit(name, usage, limit)
+
+    total_limit = budget.get("total", {})
+    write_row(out, "TOTAL", total, total_limit)
+    failures += over_limit("total", total, total_limit)
+
+    for failure in failures:
+        out.write("MEMORY BUDGET EXCEEDED - %s\n" % failure)
+    return not failures
+
+
+def report(map_path, budget_path):
+    if not os.path.exists(map_path):
+        sys.stderr.write("memory_report: map file not found: %s\n" % map_path)
+        return False
+    return check(parse_map(map_path), load_budget(budget_path))
+
+
+def main(argv):
+    if len(argv) < 2:
+        sys.stderr.write(__doc__)
+        return 2
+    budget_path = None
+    if "--budget" in argv:
+        budget_path = argv[argv.index("--budget") + 1]
+    return 0 if report(argv[1], budget_path) else 1
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+except NameError:
+    env = None
+
+if env is not None:
+    native = env.subst("$PIOPLATFORM") == "native"
+    map_path = os.path.join(env.subst("$BUILD_DIR"), env.subst("${PROGNAME}.map"))
+    budget_name = "memory_budget_native.json" if native else "memory_budget.json"
+    budget_path = os.path.join(env.subst("$PROJECT_DIR"), "tools", budget_name)
+
+    def after_link(source, target, env):
+        return 0 if report(map_path, budget_path) else 1
+
+    if native and sys.platform == "darwin":
+        sys.stderr.write("memory_report: skipped, the host linker does not write GNU ld maps\n")
+    else:
+        env.Append(LINKFLAGS=["-Wl,-Map=" + map_path])
+        env.AddPostAction("$PROGPATH", after_link)
+elif __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,172 @@
+// Compression benchmark for the telemetry codec on recorded traces.
+//
+// Build:
+//   g++ -std=c++17 -O2 -I../src -o telemetry_bench telemetry_bench.cpp ../src/telemetry_codec.cpp
+//
+// Usage:
+//   ./telemetry_bench bench_samples.csv [more.csv ...]
+//   ./telemetry_bench                     # synthetic bench trace
+//
+// Input is the <prefix>_samples.csv written by telemetry_decode. Samples are
+// packed into blocks of the size the firmware sends, every block is decoded
+// back and compared bit for bit, then the compression ratio against raw
+// 16-byte samples and the encode time per sample are printed.
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "telemetry_protocol.h"
+
+#define SYNTHETIC_SAMPLES 100000
+#define RAW_SAMPLE_BYTES 16
+
+struct BenchResult
+{
+    size_t samples;
+    size_t blocks;
+    size_t encodedBytes;
+    double encodeNs;
+    bool lossless;
+};
+
+static bool loadTrace(const char *path, std::vector<TelemetrySample> &trace)
+{
+    FILE *in = fopen(path, "r");
+    if (!in)
+    {
+        perror(path);
+        return false;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), in))
+    {
+        unsigned long timeMs;
+        TelemetrySample sample;
+        if (sscanf(line, "%lu,%f,%f,%f", &timeMs, &sample.voltage, &sample.current, &sample.power) == 4)
+        {
+            sample.timeMs = (uint32_t)timeMs;
+            trace.push_back(sample);
+        }
+    }
+    fclose(in);
+    return true;
+}
+
+// A 2 Hz bench log: slow voltage drift, load steps and occasional jitter,
+// rounded to the INA219's resolution
+static void syntheticTrace(std::vector<TelemetrySample> &trace)
+{
+    uint32_t timeMs = 1000;
+    float voltage = 12.4f;
+    float load = 1.2f;
+    srand(1);
+    for (int i = 0; i < SYNTHETIC_SAMPLES; i++)
+    {
+        timeMs += 500 + (rand() % 10 == 0 ? rand() % 40 : 0);
+        voltage -= 0.00002f;
+        if (rand() % 200 == 0)
+        {
+            load = 0.2f + (rand() % 300) / 100.0f;
+        }
+        TelemetrySample sample;
+        sample.timeMs = timeMs;
+        sample.voltage = roundf((voltage + (rand() % 3 - 1) * 0.004f) * 1000.0f) / 1000.0f;
+        sample.current = roundf((load + (rand() % 5 - 2) * 0.001f) * 1000.0f) / 1000.0f;
+        sample.power = roundf(sample.voltage * sample.current * 1000.0f) / 1000.0f;
+        trace.push_back(sample);
+    }
+}
+
+static bool sameSample(const TelemetrySample &a, const TelemetrySample &b)
+{
+    return a.timeMs == b.timeMs &&
+           memcmp(&a.voltage, &b.voltage, sizeof(float)) == 0 &&
+           memcmp(&a.current, &b.current, sizeof(float)) == 0 &&
+           memcmp(&a.power, &b.power, sizeof(float)) == 0;
+}
+
+static BenchResult runBench(const std::vector<TelemetrySample> &trace)
+{
+    BenchResult result = {};
+    result.lossless = true;
+
+    uint8_t block[TELEMETRY_MAX_PAYLOAD];
+    size_t next = 0;
+    while (next < trace.size())
+    {
+        // Time only the encoder, as the firmware runs it
+        size_t first = next;
+        auto start = std::chrono::steady_clock::now();
+        TelemetryEncoder encoder;
+        telemetryEncoderBegin(encoder, block, sizeof(block));
+        while (next < trace.size() && telemetryEncoderAdd(encoder, trace[next]))
+        {
+            next++;
+        }
+        uint16_t length = telemetryEncoderFinish(encoder);
+        result.encodeNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        result.blocks++;
+        result.encodedBytes += length;
+
+        TelemetryDecoder decoder;
+        TelemetrySample decoded;
+        size_t index = first;
+        if (!telemetryDecoderBegin(decoder, block, length))
+        {
+            result.lossless = false;
+        }
+        while (telemetryDecoderNext(decoder, decoded))
+        {
+            if (index >= next || !sameSample(decoded, trace[index]))
+            {
+                result.lossless = false;
+            }
+            index++;
+        }
+        if (index != next)
+        {
+            result.lossless = false;
+        }
+    }
+
+    result.samples = trace.size();
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<TelemetrySample> trace;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!loadTrace(argv[i], trace))
+        {
+            return 1;
+        }
+    }
+    if (argc == 1)
+    {
+        syntheticTrace(trace);
+        printf("trace: synthetic (%d samples)\n", SYNTHETIC_SAMPLES);
+    }
+    if (trace.empty())
+    {
+        fprintf(stderr, "no samples\n");
+        return 1;
+    }
+
+    BenchResult result = runBench(trace);
+    double rawBytes = (double)result.samples * RAW_SAMPLE_BYTES;
+    printf("samples: %zu, blocks: %zu (%d bytes max)\n", result.samples, result.blocks, TELEMETRY_MAX_PAYLOAD);
+    printf("raw: %.0f bytes, encoded: %zu bytes, ratio: %.2fx, %.2f bits/sample\n",
+           rawBytes, result.encodedBytes, rawBytes / result.encodedBytes,
+           result.encodedBytes * 8.0 / result.samples);
+    printf("encode: %.1f ns/sample\n", result.encodeNs / result.samples);
+    printf("round trip: %s\n", result.lossless ? "lossless" : "MISMATCH");
+    return result.lossless ? 0 : 1;
+}
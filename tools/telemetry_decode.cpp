@@ -0,0 +1,213 @@
+// Host decoder for the ENERGRAM binary telemetry stream.
+//
+// Build:
+//   g++ -std=c++17 -O2 -I../src -o telemetry_decode telemetry_decode.cpp ../src/telemetry_protocol.cpp ../src/telemetry_codec.cpp
+//
+// Usage:
+//   stty -F /dev/ttyUSB0 921600 raw
+//   ./telemetry_decode -o bench < /dev/ttyUSB0
+//
+// Writes <prefix>_samples.csv and <prefix>_events.csv (one column per field)
+// and prints frame statistics, including dropped frames, on exit. Dropped
+// frames are split into those the device reported skipping (TX buffer full)
+// and the rest, which were lost on the link.
+
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+
+#include "telemetry_protocol.h"
+
+struct DecodeStats
+{
+    unsigned long frames;
+    unsigned long badFrames;
+    unsigned long droppedFrames;
+    unsigned long samples;
+    unsigned long events;
+    unsigned long boots;
+    unsigned long deviceDropped;
+    unsigned long deviceDroppedThisBoot; // Last TX_DROPPED total since the last boot
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void handleSignal(int)
+{
+    stopRequested = 1;
+}
+
+static void writeSample(FILE *out, const TelemetrySample &sample, int charging)
+{
+    fprintf(out, "%lu,%.6g,%.6g,%.6g,%d\n", (unsigned long)sample.timeMs,
+            sample.voltage, sample.current, sample.power, charging);
+}
+
+// The device restarts its sequence numbers on every boot
+static bool isBootEvent(const TelemetryPacket &packet)
+{
+    TelemetryEvent event;
+    return packet.type == TELEMETRY_PACKET_EVENT && telemetryUnpackEvent(packet, event) &&
+           event.code == TELEMETRY_EVENT_BOOT;
+}
+
+static void handlePacket(const TelemetryPacket &packet, FILE *samplesOut, FILE *eventsOut, DecodeStats &stats)
+{
+    TelemetrySample sample;
+    TelemetryEvent event;
+    uint8_t flags;
+
+    switch (packet.type)
+    {
+        case TELEMETRY_PACKET_SAMPLE:
+            if (telemetryUnpackSample(packet, sample, flags))
+            {
+                writeSample(samplesOut, sample, (flags & TELEMETRY_FLAG_CHARGING) ? 1 : 0);
+                stats.samples++;
+            }
+            break;
+        case TELEMETRY_PACKET_EVENT:
+            if (telemetryUnpackEvent(packet, event))
+            {
+                fprintf(eventsOut, "%lu,%u,%ld\n", (unsigned long)event.timeMs, event.code, (long)event.value);
+                stats.events++;
+                if (event.code == TELEMETRY_EVENT_TX_DROPPED && (unsigned long)event.value > stats.deviceDroppedThisBoot)
+                {
+                    stats.deviceDropped += (unsigned long)event.value - stats.deviceDroppedThisBoot;
+                    stats.deviceDroppedThisBoot = (unsigned long)event.value;
+                }
+            }
+            break;
+        case TELEMETRY_PACKET_BLOCK:
+        {
+            // Compressed blocks carry no charging flag
+            TelemetryDecoder decoder;
+            if (telemetryDecoderBegin(decoder, packet.payload, packet.length))
+            {
+                while (telemetryDecoderNext(decoder, sample))
+                {
+                    writeSample(samplesOut, sample, -1);
+                    stats.samples++;
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *prefix = "telemetry";
+    const char *inputPath = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            prefix = argv[++i];
+        }
+        else if (argv[i][0] == '-' && argv[i][1] != '\0')
+        {
+            fprintf(stderr, "usage: %s [-o prefix] [input]\n", argv[0]);
+            return 2;
+        }
+        else
+        {
+            inputPath = argv[i];
+        }
+    }
+
+    FILE *in = inputPath ? fopen(inputPath, "rb") : stdin;
+    if (!in)
+    {
+        perror(inputPath);
+        return 1;
+    }
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s_samples.csv", prefix);
+    FILE *samplesOut = fopen(path, "w");
+    snprintf(path, sizeof(path), "%s_events.csv", prefix);
+    FILE *eventsOut = fopen(path, "w");
+    if (!samplesOut || !eventsOut)
+    {
+        perror("output");
+        return 1;
+    }
+    fprintf(samplesOut, "time_ms,voltage_v,current_a,power_w,charging\n");
+    fprintf(eventsOut, "time_ms,code,value\n");
+
+    signal(SIGINT, handleSignal);
+
+    DecodeStats stats = {};
+    uint8_t frame[TELEMETRY_MAX_FRAME];
+    uint8_t scratch[TELEMETRY_MAX_FRAME];
+    size_t frameLength = 0;
+    bool overflow = false;
+    bool haveSeq = false;
+    uint16_t lastSeq = 0;
+
+    int c;
+    while (!stopRequested && (c = fgetc(in)) != EOF)
+    {
+        if (c != 0x00)
+        {
+            if (frameLength < sizeof(frame))
+            {
+                frame[frameLength++] = (uint8_t)c;
+            }
+            else
+            {
+                overflow = true;
+            }
+            continue;
+        }
+
+        // Delimiter: empty frames are the padding between back-to-back packets
+        if (frameLength == 0 && !overflow)
+        {
+            continue;
+        }
+
+        TelemetryPacket packet;
+        if (overflow || !telemetryParseFrame(frame, frameLength, scratch, packet))
+        {
+            stats.badFrames++;
+        }
+        else
+        {
+            stats.frames++;
+            if (isBootEvent(packet))
+            {
+                stats.boots++;
+                stats.deviceDroppedThisBoot = 0;
+                haveSeq = false;
+            }
+            if (haveSeq)
+            {
+                stats.droppedFrames += (uint16_t)(packet.seq - lastSeq - 1);
+            }
+            lastSeq = packet.seq;
+            haveSeq = true;
+            handlePacket(packet, samplesOut, eventsOut, stats);
+        }
+        frameLength = 0;
+        overflow = false;
+    }
+
+    fclose(samplesOut);
+    fclose(eventsOut);
+    if (in != stdin)
+    {
+        fclose(in);
+    }
+
+    // Device drops also show up as sequence gaps; the rest were lost on the link
+    unsigned long deviceDropped = stats.deviceDropped < stats.droppedFrames ? stats.deviceDropped : stats.droppedFrames;
+    fprintf(stderr, "frames: %lu, bad: %lu, dropped: %lu (device: %lu, link: %lu), samples: %lu, events: %lu, boots: %lu\n",
+            stats.frames, stats.badFrames, stats.droppedFrames, deviceDropped, stats.droppedFrames - deviceDropped,
+            stats.samples, stats.events, stats.boots);
+    return 0;
+}